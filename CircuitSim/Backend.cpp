@@ -0,0 +1,311 @@
+/********************************************************************************************
+ * @file Backend.cpp
+ * @authors: Lucas Carvalho; Rafael Marasca Martins
+ * @date: 18 10 2026
+ * @brief Implementação dos backends de álgebra linear densa.
+ *
+ * Este arquivo contém o backend embutido, o backend BLAS (quando compilado com NM_USE_BLAS)
+ * e a escolha do backend em uso.
+ *
+ ********************************************************************************************/
+
+#include "Backend.h"
+#include "Numeric.h"
+#include "Gemm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef NM_USE_BLAS
+//  Interface Fortran da BLAS e do LAPACK, comum a OpenBLAS, BLIS e às implementações de
+//referência. Todos os argumentos são passados por referência.
+extern "C" {
+	void dgemm_(const char *ta, const char *tb, const int *m, const int *n, const int *k, const double *alpha,
+	            const double *a, const int *lda, const double *b, const int *ldb, const double *beta, double *c, const int *ldc);
+	void dtrsm_(const char *side, const char *uplo, const char *ta, const char *diag, const int *m, const int *n,
+	            const double *alpha, const double *a, const int *lda, double *b, const int *ldb);
+	void dgetrf_(const int *m, const int *n, double *a, const int *lda, int *ipiv, int *info);
+	void dpotrf_(const char *uplo, const int *n, double *a, const int *lda, int *info);
+}
+#endif
+
+namespace NM {
+
+	Backend::~Backend() {}
+
+	//  Aplica ao vetor b as trocas de linhas registradas em ipiv, na ordem da fatoração.
+	static void applyPivots(unsigned int n, unsigned int nrhs, const int *ipiv, double *b, unsigned int ldb) {
+		for(unsigned int k = 0; k < n; k++) {
+			const unsigned int p = ipiv[k] - 1;
+			if(p != k)
+				std::swap_ranges(b + std::size_t(k) * ldb, b + std::size_t(k) * ldb + nrhs, b + std::size_t(p) * ldb);
+		}
+	}
+
+
+	const char *BuiltinBackend::getName() const { return "builtin"; }
+
+	void BuiltinBackend::gemm(transposeOperation ta, transposeOperation tb, unsigned int m, unsigned int n, unsigned int k,
+	                          double alpha, const double *a, unsigned int lda, const double *b, unsigned int ldb,
+	                          double beta, double *c, unsigned int ldc) const {
+		const MatrixView cv(c, m, n, ldc, 1);
+		if(beta != 1)
+			for(unsigned int i = 0; i < m; i++)
+				for(unsigned int j = 0; j < n; j++)
+					cv(i, j) = (beta == 0) ? 0 : beta * cv(i, j);
+
+		if(m == 0 or n == 0 or k == 0 or alpha == 0)
+			return;
+
+		const ConstMatrixView av = (ta == NO_TRANSPOSE) ? ConstMatrixView(a, m, k, lda, 1) : ConstMatrixView(a, k, m, lda, 1).transpose();
+		const ConstMatrixView bv = (tb == NO_TRANSPOSE) ? ConstMatrixView(b, k, n, ldb, 1) : ConstMatrixView(b, n, k, ldb, 1).transpose();
+		NM::gemm(av, bv, cv, alpha);
+	}
+
+	//  As fatorações de LUDecomposition dão a permutação final das linhas; ipiv é a
+	//sequência de trocas que a produz, obtida acompanhando a posição de cada linha.
+	bool BuiltinBackend::getrf(unsigned int n, double *a, unsigned int lda, int *ipiv) const {
+		const MatrixView v(a, n, n, lda, 1);
+		std::vector<unsigned int> perm;
+		const bool regular = (n >= blockedThreshold) ? LUDecomposition::factorizeBlocked(v, perm) : LUDecomposition::factorizeInPlace(v, perm);
+
+		std::vector<unsigned int> row(n), position(n);
+		for(unsigned int i = 0; i < n; i++)
+			row[i] = position[i] = i;
+		for(unsigned int k = 0; k < n; k++) {
+			const unsigned int p = position[perm[k]];
+			ipiv[k] = p + 1;
+			std::swap(row[k], row[p]);
+			position[row[k]] = k;
+			position[row[p]] = p;
+		}
+		return regular;
+	}
+
+	void BuiltinBackend::getrs(unsigned int n, unsigned int nrhs, const double *a, unsigned int lda, const int *ipiv,
+	                           double *b, unsigned int ldb) const {
+		applyPivots(n, nrhs, ipiv, b, ldb);
+		const ConstMatrixView lu(a, n, n, lda, 1);
+		const MatrixView y(b, n, nrhs, ldb, 1);
+
+		//  Substituição direta com L (diagonal unitária).
+		for(unsigned int i = 0; i < n; i++) {
+			const double *row = &lu(i, 0);
+			for(unsigned int j = 0; j < i; j++) {
+				if(row[j] == 0)
+					continue;
+				for(unsigned int c = 0; c < nrhs; c++)
+					y(i, c) -= row[j] * y(j, c);
+			}
+		}
+
+		//  Substituição reversa com U. Pivôs nulos levam a incógnita a zero.
+		for(unsigned int i = n; i-- > 0;) {
+			const double *row = &lu(i, 0);
+			if(row[i] == 0) {
+				for(unsigned int c = 0; c < nrhs; c++)
+					y(i, c) = 0;
+				continue;
+			}
+			for(unsigned int j = i + 1; j < n; j++) {
+				if(row[j] == 0)
+					continue;
+				for(unsigned int c = 0; c < nrhs; c++)
+					y(i, c) -= row[j] * y(j, c);
+			}
+			for(unsigned int c = 0; c < nrhs; c++)
+				y(i, c) /= row[i];
+		}
+	}
+
+	//  L*D*Lt = (L*sqrt(D))*(L*sqrt(D))t: cada coluna de L é escalada pela raiz do pivô.
+	bool BuiltinBackend::potrf(unsigned int n, double *a, unsigned int lda) const {
+		const MatrixView v(a, n, n, lda, 1);
+		if(not ((n >= blockedThreshold) ? CholeskyDecomposition::factorizeBlocked(v) : CholeskyDecomposition::factorizeInPlace(v)))
+			return false;
+
+		for(unsigned int j = 0; j < n; j++) {
+			if(v(j, j) <= 0)
+				return false;
+			const double s = std::sqrt(v(j, j));
+			v(j, j) = s;
+			for(unsigned int i = j + 1; i < n; i++)
+				v(i, j) *= s;
+		}
+		return true;
+	}
+
+	void BuiltinBackend::potrs(unsigned int n, unsigned int nrhs, const double *a, unsigned int lda, double *b, unsigned int ldb) const {
+		const ConstMatrixView l(a, n, n, lda, 1);
+		const MatrixView y(b, n, nrhs, ldb, 1);
+
+		//  Substituição direta com L.
+		for(unsigned int i = 0; i < n; i++) {
+			const double *row = &l(i, 0);
+			for(unsigned int j = 0; j < i; j++)
+				for(unsigned int c = 0; c < nrhs; c++)
+					y(i, c) -= row[j] * y(j, c);
+			for(unsigned int c = 0; c < nrhs; c++)
+				y(i, c) /= row[i];
+		}
+
+		//  Substituição reversa com Lt, orientada por linhas de L.
+		for(unsigned int i = n; i-- > 0;) {
+			const double *row = &l(i, 0);
+			for(unsigned int c = 0; c < nrhs; c++)
+				y(i, c) /= row[i];
+			for(unsigned int j = 0; j < i; j++)
+				for(unsigned int c = 0; c < nrhs; c++)
+					y(j, c) -= row[j] * y(i, c);
+		}
+	}
+
+
+#ifdef NM_USE_BLAS
+	//  Uma matriz armazenada por linhas é a transposta da mesma memória lida por colunas.
+	//Assim, c = op(a)*op(b) por linhas é ct = op(b)t*op(a)t por colunas, e as substituições
+	//de getrs e potrs viram substituições à direita (dtrsm com side = 'R') sobre bt.
+
+	const char *BlasBackend::getName() const { return "blas"; }
+
+	void BlasBackend::gemm(transposeOperation ta, transposeOperation tb, unsigned int m, unsigned int n, unsigned int k,
+	                       double alpha, const double *a, unsigned int lda, const double *b, unsigned int ldb,
+	                       double beta, double *c, unsigned int ldc) const {
+		if(m == 0 or n == 0)
+			return;
+
+		const char opA = (ta == NO_TRANSPOSE) ? 'N' : 'T', opB = (tb == NO_TRANSPOSE) ? 'N' : 'T';
+		const int M = n, N = m, K = k, LDA = std::max(1u, lda), LDB = std::max(1u, ldb), LDC = std::max(1u, ldc);
+		dgemm_(&opB, &opA, &M, &N, &K, &alpha, b, &LDB, a, &LDA, &beta, c, &LDC);
+	}
+
+	//  Transpõe o bloco n x n no próprio lugar.
+	static void transposeInPlace(unsigned int n, double *a, unsigned int lda) {
+		for(unsigned int i = 0; i < n; i++)
+			for(unsigned int j = i + 1; j < n; j++)
+				std::swap(a[std::size_t(i) * lda + j], a[std::size_t(j) * lda + i]);
+	}
+
+	//  dgetrf por colunas sobre a memória transposta pivotaria as colunas de A. A matriz é
+	//transposta antes e depois (O(n²), desprezível diante da fatoração) para que as
+	//linhas sejam pivotadas, como no backend embutido.
+	bool BlasBackend::getrf(unsigned int n, double *a, unsigned int lda, int *ipiv) const {
+		if(n == 0)
+			return true;
+
+		const int N = n, LDA = lda;
+		int info = 0;
+		transposeInPlace(n, a, lda);
+		dgetrf_(&N, &N, a, &LDA, ipiv, &info);
+		transposeInPlace(n, a, lda);
+
+		if(info < 0)
+			throw std::string("Argumento invalido para dgetrf");
+		return info == 0;
+	}
+
+	//  L*U*x = P*b: lida por colunas, a memória de a contém Ut (triangular inferior) e Lt
+	//(triangular superior, diagonal unitária), e xt*Ut*Lt = (P*b)t.
+	void BlasBackend::getrs(unsigned int n, unsigned int nrhs, const double *a, unsigned int lda, const int *ipiv,
+	                        double *b, unsigned int ldb) const {
+		if(n == 0 or nrhs == 0)
+			return;
+
+		applyPivots(n, nrhs, ipiv, b, ldb);
+		const int M = nrhs, N = n, LDA = lda, LDB = std::max(1u, ldb);
+		const double one = 1;
+		dtrsm_("R", "U", "N", "U", &M, &N, &one, a, &LDA, b, &LDB);
+		dtrsm_("R", "L", "N", "N", &M, &N, &one, a, &LDA, b, &LDB);
+	}
+
+	//  O triângulo inferior por linhas é o superior por colunas, e o fator U de A = Ut*U
+	//por colunas é o fator L de A = L*Lt por linhas.
+	bool BlasBackend::potrf(unsigned int n, double *a, unsigned int lda) const {
+		if(n == 0)
+			return true;
+
+		const int N = n, LDA = lda;
+		int info = 0;
+		dpotrf_("U", &N, a, &LDA, &info);
+
+		if(info < 0)
+			throw std::string("Argumento invalido para dpotrf");
+		return info == 0;
+	}
+
+	//  A*x = b com A = L*Lt equivale a xt*Lt*L = bt, com Lt triangular superior por colunas.
+	void BlasBackend::potrs(unsigned int n, unsigned int nrhs, const double *a, unsigned int lda, double *b, unsigned int ldb) const {
+		if(n == 0 or nrhs == 0)
+			return;
+
+		const int M = nrhs, N = n, LDA = lda, LDB = std::max(1u, ldb);
+		const double one = 1;
+		dtrsm_("R", "U", "N", "N", &M, &N, &one, a, &LDA, b, &LDB);
+		dtrsm_("R", "U", "T", "N", &M, &N, &one, a, &LDA, b, &LDB);
+	}
+#endif
+
+
+	static const BuiltinBackend builtinBackend;
+#ifdef NM_USE_BLAS
+	static const BlasBackend blasBackend;
+#endif
+
+	static backendType requestedBackend = AUTOMATIC_BACKEND;
+
+	bool isBackendAvailable(backendType t) {
+		switch(t) {
+			case AUTOMATIC_BACKEND:
+			case BUILTIN_BACKEND:
+				return true;
+#ifdef NM_USE_BLAS
+			case BLAS_BACKEND:
+				return true;
+#endif
+			default:
+				return false;
+		}
+	}
+
+	//  A variável de ambiente é lida uma única vez. Sem ela (ou com "blas"), a BLAS é usada
+	//se tiver sido compilada; valores desconhecidos são ignorados.
+	static backendType defaultBackend() {
+		static const backendType chosen = [] {
+			const char *env = std::getenv("NM_BACKEND");
+			const std::string name = (env != nullptr) ? env : "";
+			if(name == "builtin")
+				return BUILTIN_BACKEND;
+			return isBackendAvailable(BLAS_BACKEND) ? BLAS_BACKEND : BUILTIN_BACKEND;
+		}();
+		return chosen;
+	}
+
+	void setBackend(backendType t) {
+		if(not isBackendAvailable(t))
+			throw std::string("Backend nao disponivel");
+		requestedBackend = t;
+	}
+
+	backendType getBackendType() { return (requestedBackend == AUTOMATIC_BACKEND) ? defaultBackend() : requestedBackend; }
+
+	const Backend &getBackend() { return getBackend(getBackendType()); }
+
+	const Backend &getBackend(backendType t) {
+		switch(t) {
+			case AUTOMATIC_BACKEND:
+				return getBackend();
+			case BUILTIN_BACKEND:
+				return builtinBackend;
+#ifdef NM_USE_BLAS
+			case BLAS_BACKEND:
+				return blasBackend;
+#endif
+			default:
+				throw std::string("Backend nao disponivel");
+		}
+	}
+}
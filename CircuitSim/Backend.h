@@ -0,0 +1,244 @@
+/********************************************************************************************
+ * @file Backend.h
+ * @authors: Lucas Carvalho; Rafael Marasca Martins
+ * @date: 18 10 2026
+ * @brief Declaração dos backends de álgebra linear densa.
+ *
+ * Este arquivo contém a interface comum às implementações das operações densas usadas pelo
+ * namespace NM (multiplicação de matrizes e fatorações LU e de Cholesky) e as funções que
+ * escolhem a implementação em uso.
+ *
+ * O backend embutido usa os algoritmos do próprio NM. Se o programa for compilado com
+ * NM_USE_BLAS (e ligado a uma BLAS/LAPACK, como OpenBLAS, BLIS ou a implementação de
+ * referência), o backend BLAS também fica disponível. A escolha é feita em tempo de
+ * execução, por setBackend ou pela variável de ambiente NM_BACKEND ("builtin" ou "blas").
+ *
+ ********************************************************************************************/
+
+#ifndef BACKEND_H
+#define BACKEND_H
+
+namespace NM {
+
+   /*************************************************************************
+    * Fornece uma identificação para os backends de álgebra linear.
+    *************************************************************************/
+	enum backendType {
+		AUTOMATIC_BACKEND, /**< NM_BACKEND, se definida; senão BLAS, se disponível, ou o embutido.*/
+		BUILTIN_BACKEND, /**< Algoritmos do próprio NM.*/
+		BLAS_BACKEND /**< BLAS/LAPACK do sistema (exige NM_USE_BLAS).*/
+	};
+
+
+   /*************************************************************************
+    * Fornece uma identificação para a operação aplicada a um operando.
+    *************************************************************************/
+	enum transposeOperation {
+		NO_TRANSPOSE, /**< O operando é usado como está.*/
+		TRANSPOSE /**< O operando é transposto.*/
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe Backend.
+    *
+    * Interface das operações densas, no estilo da BLAS e do LAPACK. As
+    * matrizes são armazenadas por linhas, como em NM::Matrix: o elemento
+    * (i, j) de a está em a[i*lda + j]. Os vetores de pivôs seguem a
+    * convenção do LAPACK: no passo k, a linha k foi trocada com a linha
+    * ipiv[k] - 1.
+    *************************************************************************/
+	class Backend {
+	public:
+		virtual ~Backend();
+
+	   /*************************************************************************
+    	* Getter para o nome do backend.
+    	*
+    	* @return Nome exibido nos diagnósticos.
+    	*************************************************************************/
+		virtual const char *getName() const = 0;
+
+	   /*************************************************************************
+    	* Multiplicação de matrizes.
+    	*
+    	* Calcula c = alpha*op(a)*op(b) + beta*c. Com beta nulo, c não é lida.
+    	*
+    	* @param ta Operação aplicada a a.
+    	* @param tb Operação aplicada a b.
+    	* @param m Linhas de op(a) e de c.
+    	* @param n Colunas de op(b) e de c.
+    	* @param k Colunas de op(a) e linhas de op(b).
+    	* @param alpha Escala do produto.
+    	* @param a Primeiro operando.
+    	* @param lda Distância entre as linhas de a.
+    	* @param b Segundo operando.
+    	* @param ldb Distância entre as linhas de b.
+    	* @param beta Escala de c.
+    	* @param c Destino.
+    	* @param ldc Distância entre as linhas de c.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		virtual void gemm(transposeOperation ta, transposeOperation tb, unsigned int m, unsigned int n, unsigned int k,
+		                  double alpha, const double *a, unsigned int lda, const double *b, unsigned int ldb,
+		                  double beta, double *c, unsigned int ldc) const = 0;
+
+	   /*************************************************************************
+    	* Fatoração LU com pivoteamento parcial.
+    	*
+    	* Sobrescreve a com os fatores de P*A = L*U (L com diagonal unitária
+		* implícita), com as linhas trocadas fisicamente. Um pivô nulo não
+		* interrompe a fatoração.
+    	*
+    	* @param n Dimensão da matriz.
+    	* @param a Matriz quadrada (entrada) e fatores L e U (saída).
+    	* @param lda Distância entre as linhas de a.
+    	* @param ipiv Vetor de n posições que recebe os pivôs.
+		*
+    	* @return true se nenhum pivô nulo foi encontrado.
+    	*************************************************************************/
+		virtual bool getrf(unsigned int n, double *a, unsigned int lda, int *ipiv) const = 0;
+
+	   /*************************************************************************
+    	* Resolve A*X = B a partir da fatoração de getrf.
+    	*
+    	* @param n Dimensão da matriz.
+    	* @param nrhs Número de lados direitos (colunas de b).
+    	* @param a Fatores L e U.
+    	* @param lda Distância entre as linhas de a.
+    	* @param ipiv Pivôs da fatoração.
+    	* @param b Lados direitos (entrada) e solução (saída).
+    	* @param ldb Distância entre as linhas de b.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		virtual void getrs(unsigned int n, unsigned int nrhs, const double *a, unsigned int lda, const int *ipiv,
+		                   double *b, unsigned int ldb) const = 0;
+
+	   /*************************************************************************
+    	* Fatoração de Cholesky.
+    	*
+    	* Sobrescreve o triângulo inferior de a com o fator L de A = L*Lt. O
+		* triângulo superior não é lido nem escrito.
+    	*
+    	* @param n Dimensão da matriz.
+    	* @param a Matriz simétrica (entrada) e fator L (saída).
+    	* @param lda Distância entre as linhas de a.
+		*
+    	* @return true se a matriz é positiva definida. Caso contrário, o
+		* conteúdo de a fica indefinido.
+    	*************************************************************************/
+		virtual bool potrf(unsigned int n, double *a, unsigned int lda) const = 0;
+
+	   /*************************************************************************
+    	* Resolve A*X = B a partir da fatoração de potrf.
+    	*
+    	* @param n Dimensão da matriz.
+    	* @param nrhs Número de lados direitos (colunas de b).
+    	* @param a Fator L.
+    	* @param lda Distância entre as linhas de a.
+    	* @param b Lados direitos (entrada) e solução (saída).
+    	* @param ldb Distância entre as linhas de b.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		virtual void potrs(unsigned int n, unsigned int nrhs, const double *a, unsigned int lda, double *b, unsigned int ldb) const = 0;
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe BuiltinBackend.
+    *
+    * Backend com os algoritmos do NM: a multiplicação blocada de Gemm.h e
+    * as fatorações de LUDecomposition e CholeskyDecomposition. Em getrs,
+    * pivôs nulos levam a incógnita correspondente a zero.
+    *************************************************************************/
+	class BuiltinBackend : public Backend {
+	public:
+		const char *getName() const override;
+		void gemm(transposeOperation ta, transposeOperation tb, unsigned int m, unsigned int n, unsigned int k,
+		          double alpha, const double *a, unsigned int lda, const double *b, unsigned int ldb,
+		          double beta, double *c, unsigned int ldc) const override;
+		bool getrf(unsigned int n, double *a, unsigned int lda, int *ipiv) const override;
+		void getrs(unsigned int n, unsigned int nrhs, const double *a, unsigned int lda, const int *ipiv,
+		           double *b, unsigned int ldb) const override;
+		bool potrf(unsigned int n, double *a, unsigned int lda) const override;
+		void potrs(unsigned int n, unsigned int nrhs, const double *a, unsigned int lda, double *b, unsigned int ldb) const override;
+	};
+
+
+#ifdef NM_USE_BLAS
+   /*************************************************************************
+    * Declaração da classe BlasBackend.
+    *
+    * Backend que chama a BLAS/LAPACK do sistema (interface Fortran). Como
+    * essas bibliotecas armazenam as matrizes por colunas, as operações são
+    * reescritas sobre as transpostas, sem cópias.
+    *************************************************************************/
+	class BlasBackend : public Backend {
+	public:
+		const char *getName() const override;
+		void gemm(transposeOperation ta, transposeOperation tb, unsigned int m, unsigned int n, unsigned int k,
+		          double alpha, const double *a, unsigned int lda, const double *b, unsigned int ldb,
+		          double beta, double *c, unsigned int ldc) const override;
+		bool getrf(unsigned int n, double *a, unsigned int lda, int *ipiv) const override;
+		void getrs(unsigned int n, unsigned int nrhs, const double *a, unsigned int lda, const int *ipiv,
+		           double *b, unsigned int ldb) const override;
+		bool potrf(unsigned int n, double *a, unsigned int lda) const override;
+		void potrs(unsigned int n, unsigned int nrhs, const double *a, unsigned int lda, double *b, unsigned int ldb) const override;
+	};
+#endif
+
+
+   /*************************************************************************
+    * Escolhe o backend de álgebra linear.
+    *
+    * Deve ser chamado antes de qualquer operação concorrente.
+    *
+    * @param t Backend desejado. AUTOMATIC_BACKEND volta à escolha padrão.
+	*
+    * @return Void.
+    *************************************************************************/
+	void setBackend(backendType t);
+
+
+   /*************************************************************************
+    * Getter para o tipo do backend em uso.
+    *
+    * @return Backend efetivamente usado (nunca AUTOMATIC_BACKEND).
+    *************************************************************************/
+	backendType getBackendType();
+
+
+   /*************************************************************************
+    * Getter para o backend em uso.
+    *
+    * @return Backend efetivamente usado.
+    *************************************************************************/
+	const Backend &getBackend();
+
+
+   /*************************************************************************
+    * Getter para um backend específico.
+    *
+    * @param t Backend desejado.
+	*
+    * @return Backend t (o backend em uso, se t for AUTOMATIC_BACKEND).
+	*
+	* @overload
+    *************************************************************************/
+	const Backend &getBackend(backendType t);
+
+
+   /*************************************************************************
+    * Verifica se um backend foi compilado no programa.
+    *
+    * @param t Backend consultado.
+	*
+    * @return true se o backend pode ser usado.
+    *************************************************************************/
+	bool isBackendAvailable(backendType t);
+}
+
+#endif
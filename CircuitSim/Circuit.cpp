@@ -14,15 +14,84 @@
 #include "Circuit.h"
 #include "Graph.h"
 #include "Numeric.h"
+#include "Iterative.h"
+#include "ThreadPool.h"
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <stack>
 #include <fstream>
+#include <chrono>
+#include <cstdio>
 
 namespace CCT{
-	
-	Circuit::Circuit(){}
+
+    //Número de malhas a partir do qual o sistema é resolvido sem ser montado.
+	static const unsigned int matrixFreeThreshold = 5000;
+
+    //Cordas por tarefa na extração paralela dos circuitos fundamentais.
+	static const unsigned int loopBlock = 256;
+
+    //Tolerância relativa da solução do sistema das malhas.
+	static const double loopTolerance = 5e-8;
+
+    //Raio das buscas que geram os candidatos da base de ciclos curtos.
+	static const unsigned int shortCycleRadius = 2;
+
+    //Segundos decorridos desde t.
+	static double secondsSince(std::chrono::steady_clock::time_point t) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count();
+	}
+
+	std::string toJson(const SolveStats &s) {
+		static const char *paths[] = {"none", "matrix-free", "assembly", "update", "cached"};
+		static const char *methods[] = {"automatic", "gauss-seidel", "lu", "cholesky", "conjugate-gradient", "mixed-precision"};
+		static const char *bases[] = {"bfs", "central-bfs", "low-stretch", "short-cycle"};
+
+		char line[1024];
+		std::snprintf(line, sizeof(line),
+			"{\"spanning_tree_s\":%.9g,\"loops_s\":%.9g,\"assembly_s\":%.9g,\"factorization_s\":%.9g,"
+			"\"solve_s\":%.9g,\"update_s\":%.9g,\"total_s\":%.9g,\"vertices\":%u,\"edges\":%u,\"loops\":%u,"
+			"\"loop_length\":%zu,\"nnz\":%zu,\"path\":\"%s\",\"method\":\"%s\",\"iterations\":%u,"
+			"\"residual\":%.6g,\"converged\":%s,\"bytes\":%zu,\"basis\":\"%s\"}",
+			s.spanningTreeTime, s.loopsTime, s.assemblyTime, s.factorizationTime, s.solveTime, s.updateTime, s.totalTime,
+			s.vertices, s.edges, s.loops, s.loopLength, s.nonZeros, paths[s.path], methods[s.method], s.iterations,
+			s.residual, s.converged ? "true" : "false", s.bytes, bases[s.basis]);
+		return line;
+	}
+
+	LoopOperator::LoopOperator(const std::vector<signedLoop> &l, const std::vector<double> &r)
+		: loops(l), resistances(r) {}
+
+	unsigned int LoopOperator::getSize() const { return loops.size(); }
+
+	void LoopOperator::apply(const double *x, double *y) const {
+        //Correntes de ramo: Bt*x.
+		branch.assign(resistances.size(), 0.0);
+		for(unsigned int j = 0; j < loops.size(); j++)
+			for(const std::pair<unsigned int, int> &e : loops[j])
+				branch[e.first] += e.second * x[j];
+
+        //Queda de tensão de cada ramo somada em cada malha: B*Z*(Bt*x).
+		for(unsigned int j = 0; j < loops.size(); j++) {
+			double s = 0;
+			for(const std::pair<unsigned int, int> &e : loops[j])
+				s += e.second * resistances[e.first] * branch[e.first];
+			y[j] = s;
+		}
+	}
+
+	void LoopOperator::getDiagonal(double *d) const {
+		for(unsigned int j = 0; j < loops.size(); j++) {
+			d[j] = 0;
+			for(const std::pair<unsigned int, int> &e : loops[j])
+				d[j] += resistances[e.first];
+		}
+	}
+
+	Circuit::Circuit() : topologyChanged(true), resistancesChanged(true), rhs(0, 1), loopCurrents(0, 1), updateVectors(0, 0),
+		loopOperator(circuitMatrix, resistances), loopNonZeros(0), stats(), statsStream(nullptr), basis(BFS_BASIS) {}
 
 	Circuit::~Circuit() {
         //Libera a memória utilizada pelos componentes armazenados no circuito.
@@ -31,13 +100,10 @@ namespace CCT{
 		}
 	}
 
-    void Circuit::updateComponents(std::vector<double> currents) {
-		std::pair<unsigned int, unsigned int> vtx;
-		std::vector<unsigned int> aux;
+    void Circuit::updateComponents(const std::vector<double> &currents) {
 
         //Percorre o vector de componentes e atualiza o falor da corrente.
 		for(unsigned int i = 0; i < components.size(); i++) {
-			vtx = getVertex (i); 
 			components[i]->setCurrent(currents[i]);
 
             //Se for um resitor, atualiza a tensão através dos terminais.
@@ -52,37 +118,142 @@ namespace CCT{
         if(getVertexNumber() == 0)
             return;
 
-		incidenceMatrix temp,sTree = getSpanningTree(0);
-		std::pair<unsigned int, unsigned int> edg;
-
-        //Percorre o grafo original, verifica se o vértice está presente na árvore geradora
-        //Para cada aresta não presente, adiciona esta à árvore geradora e encontra o único
-        //ciclo existente e remove a aresta previamente adicionada.
-		for(unsigned int i = 0; i<getEdgeNumber(); i++) {
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		stats = SolveStats();
 
-            //Verifica se a aresta existe na árvore
-            edg = sTree.getVertex(i);
+        //Se apenas valores foram editados, os circuitos fundamentais continuam válidos.
+        if(topologyChanged)
+            findLoops();
 
-            if(edg.first == edg.second){
-				chords.push_back(i);
-				edg = getVertex(i);
-				temp = sTree;
-				temp.makeCon(edg.first,edg.second,i);
-                //Assimila o ciclo fundamental.
-				circuitMatrix.push_back(temp.getLoop(edg.first));
-			}
-		}
         //Resolve o circuito.
 		Solve();
+
+		stats.vertices = getVertexNumber();
+		stats.edges = getEdgeNumber();
+		stats.loops = chords.size();
+		stats.basis = basis;
+		stats.totalTime = secondsSince(start);
+		if(statsStream)
+			*statsStream << toJson(stats) << '\n';
+	}
+
+	void Circuit::findLoops() {
+        reset();
+
+		std::chrono::steady_clock::time_point phase = std::chrono::steady_clock::now();
+
+        //Floresta geradora em O(V + E), com uma árvore por componente conexa.
+		GRF::spanningForest forest;
+		if(basis == LOW_STRETCH_BASIS)
+			forest = getLowStretchSpanningForest();
+		else if(basis == BFS_BASIS)
+			forest = getSpanningForest(0);
+		else
+			forest = getCentralSpanningForest();
+		stats.spanningTreeTime = secondsSince(phase);
+		phase = std::chrono::steady_clock::now();
+
+		if(basis == SHORT_CYCLE_BASIS){
+			chords = forest.chords;
+			circuitMatrix = getShortCycleBasis(forest, shortCycleRadius);
+			topologyChanged = false;
+			stats.loopsTime = secondsSince(phase);
+			return;
+		}
+
+        //Cada corda fecha um ciclo fundamental com o caminho da árvore entre os seus extremos.
+        //Os ciclos são independentes, e são extraídos em paralelo, em blocos de cordas.
+		chords = forest.chords;
+		circuitMatrix.resize(chords.size());
+		const unsigned int blocks = (chords.size() + loopBlock - 1) / loopBlock;
+		NM::getThreadPool().parallelFor(blocks, [&](unsigned int b) {
+			const unsigned int end = std::min<std::size_t>(chords.size(), (b + 1) * loopBlock);
+			for(unsigned int j = b * loopBlock; j < end; j++)
+				getFundamentalLoop(forest, chords[j], circuitMatrix[j]);
+		});
+        topologyChanged = false;
+		stats.loopsTime = secondsSince(phase);
+	}
+
+    //Os temporários da montagem vêm da arena; apenas A, criada fora do escopo, fica na memória
+    //comum e sobrevive ao reset da arena.
+	void Circuit::assembleLoopSystem() {
+		const std::chrono::steady_clock::time_point phase = std::chrono::steady_clock::now();
+		NM::SparseMatrix A;
+		{
+			NM::ArenaScope scope(arena);
+			std::vector<NM::Triplet, NM::AlignedAllocator<NM::Triplet>> loops;
+			for(unsigned int j = 0; j < chords.size(); j++)
+				for(const std::pair<unsigned int, int> &e : circuitMatrix[j])
+					loops.push_back({j, e.first, double(e.second)});
+
+			NM::SparseMatrix B(chords.size(), getEdgeNumber(), loops.data(), loops.size());
+			NM::SparseMatrix Z = NM::SparseMatrix::diagonal(resistances);
+			A = (B * Z) * B.transpose();
+		}
+		arena.reset();
+		loopNonZeros = A.getNonZeros();
+
+        //Um sistema existente reaproveita a análise simbólica do mesmo padrão.
+		if(loopSystem)
+			loopSystem->setCoefficients(std::move(A), NM::SYMMETRIC);
+		else
+			loopSystem.reset(new NM::EquationSystem(std::move(A), rhs, NM::SYMMETRIC));
+		stats.assemblyTime += secondsSince(phase);
+		stats.path = ASSEMBLY_PATH;
+	}
+
+    //Duas malhas têm uma entrada em B*Z*Bt se compartilham uma aresta. As malhas de cada aresta
+    //ficam em forma compacta (start/loops), e mark evita contar duas vezes o mesmo par.
+	void Circuit::countLoopNonZeros() {
+		std::vector<unsigned int> start(getEdgeNumber() + 1, 0);
+		for(const signedLoop &loop : circuitMatrix)
+			for(const std::pair<unsigned int, int> &e : loop)
+				start[e.first + 1]++;
+		for(unsigned int e = 0; e < getEdgeNumber(); e++)
+			start[e + 1] += start[e];
+
+		std::vector<unsigned int> loops(start.back()), next(start.begin(), start.end() - 1);
+		for(unsigned int j = 0; j < circuitMatrix.size(); j++)
+			for(const std::pair<unsigned int, int> &e : circuitMatrix[j])
+				loops[next[e.first]++] = j;
+
+		std::vector<unsigned int> mark(circuitMatrix.size(), ~0u);
+		loopNonZeros = 0;
+		for(unsigned int i = 0; i < circuitMatrix.size(); i++)
+			for(const std::pair<unsigned int, int> &e : circuitMatrix[i])
+				for(unsigned int k = start[e.first]; k < start[e.first + 1]; k++)
+					if(mark[loops[k]] != i){
+						mark[loops[k]] = i;
+						loopNonZeros++;
+					}
+	}
+
+	const SolveStats &Circuit::getStats() const { return stats; }
+
+	void Circuit::setStatsStream(std::ostream *out) { statsStream = out; }
+
+	void Circuit::setLoopBasis(loopBasis b) {
+		if(b == basis)
+			return;
+		basis = b;
+		topologyChanged = true;
 	}
 
+	loopBasis Circuit::getLoopBasis() const { return basis; }
+
     //Reseta as matrizes de circuito e acorde, para que o circuito possa ser resolvido
     //após a edição sem que ocorram erros.
     void Circuit::reset() {
-		while(chords.size())
-			chords.pop_back();
-		while(circuitMatrix.size())
-			circuitMatrix.pop_back();
+        if(not topologyChanged)
+            return;
+
+		chords.clear();
+		circuitMatrix.clear();
+		loopNonZeros = 0;
+		loopSystem.reset();
+		resistancesChanged = true;
+		resistanceUpdates.clear();
     }
 
     void Circuit::addComponent(CMP::type t,  std::string l,  double value,  unsigned int vtx1,  unsigned int vtx2){
@@ -110,6 +281,7 @@ namespace CCT{
 
         //Adiciona a aresta ao grafo.
 		addEdge(vtx1, vtx2);
+		topologyChanged = true;
 
         //Adiciona o componente inserido no vector de componentes do circuito.
 		components.push_back(C);
@@ -132,8 +304,10 @@ namespace CCT{
                     case CMP::RESISTOR:{
                         CMP::Resistor *R = dynamic_cast<CMP::Resistor*> (components[i]);
 						
-						if(R!=NULL)
+						if(R!=NULL){
+							resistanceUpdates.push_back({i, value - R->getResistance()});
 							R->setResistance(value);
+						}
 						else
 							throw std::string("Erro ao atualizar componente.");
 						return;
@@ -182,6 +356,7 @@ namespace CCT{
             if(components[i]->getLabel() == l){
 				aux = getVertex(i);
 				removeEdge(i);
+				topologyChanged = true;
                 bool removedFirst = false;
 
 				if(not getConNum(aux.first))
@@ -227,54 +402,122 @@ namespace CCT{
 
 
 	void Circuit::Solve() {
+		std::chrono::steady_clock::time_point phase = std::chrono::steady_clock::now();
 
-        //Matriz de impedância (resistência) do circuito.
-		NM::Matrix Z(getEdgeNumber(), getEdgeNumber());
-
-        //Matriz das fontes de tensão do circuito.
-		NM::Matrix Vin(getEdgeNumber());
-
-        //Matriz das correntes do circuito.
-		NM::Matrix I(getEdgeNumber());
-
-        //Matriz das conexões do circuito.
-		NM::Matrix M(getVertexNumber(),getEdgeNumber());
+        //Resistências, fontes e correntes dos ramos, sobre os buffers da solução anterior.
+		resistances.assign(getEdgeNumber(), 0);
+		voltages.assign(getEdgeNumber(), 0);
+		currents.assign(getEdgeNumber(), 0);
 
         //Adiciona as resistências dos componentes à matriz de impedância.
 		for(unsigned int i = 0; i < getEdgeNumber(); i++) {
             if(components[i]->getType() == CMP::VCC)
-                Vin[i][0] = (components[i]->getVoltage());
+                voltages[i] = components[i]->getVoltage();
             else if(components[i]->getType() == CMP::RESISTOR){
                 CMP::Resistor *R = dynamic_cast<CMP::Resistor*> (components[i]);
 		
 			if(R != NULL)
-                Z[i][i] = R->getResistance();
-			}
-
-			for(unsigned int j = 0; j < getVertexNumber(); j++){
-				M[j][i] = double(inMatrix[j][i]);
+                resistances[i] = R->getResistance();
 			}
 		}
 
         //Resolve o circuito caso o circuito seja fechado.
 		if(chords.size() != 0){
-			NM::Matrix B(chords.size(), getEdgeNumber());
-			for(unsigned int i = 0; i < getEdgeNumber(); i++){
-				for(unsigned int j = 0; j < chords.size(); j++){
-					B[j][i] = double(circuitMatrix[j][i]);
+            //Lado direito B*Vin, somando as fontes ao longo de cada malha.
+			rhs.resize(chords.size(), 1);
+			for(unsigned int j = 0; j < chords.size(); j++)
+				for(const std::pair<unsigned int, int> &e : circuitMatrix[j])
+					rhs(j, 0) += e.second * voltages[e.first];
+
+			loopCurrents.resize(chords.size(), 1);
+			for(const signedLoop &loop : circuitMatrix)
+				stats.loopLength += loop.size();
+			stats.assemblyTime = secondsSince(phase);
+			bool solved = false;
+
+            //Circuitos grandes: gradiente conjugado sobre o operador, sem montar B*Z*Bt.
+			if(chords.size() >= matrixFreeThreshold and not loopSystem){
+				phase = std::chrono::steady_clock::now();
+				jacobi.setup(loopOperator);
+				NM::ConjugateGradient cg(loopTolerance, 10 * chords.size(), &jacobi, &workspace);
+				const NM::SolverReport r = cg.solve(loopOperator, rhs, loopCurrents);
+				solved = r.converged;
+				stats.solveTime = secondsSince(phase);
+				if(loopNonZeros == 0)
+					countLoopNonZeros();
+				stats.path = MATRIX_FREE_PATH;
+				stats.method = r.method;
+				stats.iterations = r.iterations;
+				stats.residual = r.residual;
+				stats.converged = r.converged;
+			}
+
+            //Caso contrário (ou se o método iterativo falhar), monta a matriz esparsa. A
+            //matriz só é remontada se alguma resistência mudou; se apenas as fontes mudaram,
+            //o sistema em cache resolve o novo lado direito com a fatoração existente.
+			if(not solved){
+				phase = std::chrono::steady_clock::now();
+				stats.path = CACHED_PATH;
+				bool assemble = resistancesChanged or not loopSystem;
+
+                //Cada resistência editada soma delta*b*bt a B*Z*Bt, onde b é a coluna de B da
+                //aresta: as malhas que a contêm, com o sentido de percurso. Se o sistema recusar
+                //a atualização (fatoração singular, ou uma malha só de fios com a diagonal
+                //anulada), a matriz é remontada, em vez de refatorar a matriz modificada.
+				if(not assemble and not resistanceUpdates.empty()){
+					updateVectors.resize(chords.size(), resistanceUpdates.size());
+					updateDeltas.resize(resistanceUpdates.size());
+
+					for(unsigned int c = 0; c < resistanceUpdates.size(); c++)
+						updateDeltas[c] = resistanceUpdates[c].second;
+
+					for(unsigned int j = 0; j < chords.size(); j++)
+						for(const std::pair<unsigned int, int> &e : circuitMatrix[j])
+							for(unsigned int c = 0; c < resistanceUpdates.size(); c++)
+								if(e.first == resistanceUpdates[c].first)
+									updateVectors(j, c) = e.second;
+
+					assemble = not loopSystem->updateCoefficients(updateVectors, updateDeltas);
+					stats.updateTime = secondsSince(phase);
+					stats.path = UPDATE_PATH;
 				}
+				if(assemble)
+					assembleLoopSystem();
+				loopSystem->solve(rhs, loopCurrents, loopTolerance, 1000);
+
+                //Salvaguarda: uma solução sobre a fatoração atualizada que ainda assim não atinge
+                //a tolerância é descartada, e o sistema remontado e refatorado.
+				if(stats.path == UPDATE_PATH and (loopSystem->getReport().residual > loopTolerance or
+				                                  not loopSystem->getReport().converged)){
+					assembleLoopSystem();
+					loopSystem->solve(rhs, loopCurrents, loopTolerance, 1000);
+				}
+
+				const NM::SolverReport r = loopSystem->getReport();
+				stats.factorizationTime = r.factorizationTime;
+				stats.solveTime += r.time - r.factorizationTime;
+				stats.method = r.method;
+				stats.iterations = r.iterations;
+				stats.residual = r.residual;
+				stats.converged = r.converged;
 			}
+			resistancesChanged = false;
+			resistanceUpdates.clear();
 
-			NM::Matrix Bt = B.transpose();
-			NM::Matrix A = B * Z;
-			A *= (Bt);
-			B *= Vin;
-			NM::EquationSystem curSys(A, B);
-			I = curSys.getSolution(5e-8, 1000);
-			I= Bt * I;
+            //Correntes de ramo: Bt*x.
+			for(unsigned int j = 0; j < chords.size(); j++)
+				for(const std::pair<unsigned int, int> &e : circuitMatrix[j])
+					currents[e.first] += e.second * loopCurrents(j, 0);
 		}
+
+        //Memória mantida entre soluções.
+		stats.bytes = arena.getCapacity() + workspace.getBytes() + stats.loopLength * sizeof(std::pair<unsigned int, int>) +
+		              (resistances.capacity() + voltages.capacity() + currents.capacity()) * sizeof(double);
+		stats.nonZeros = loopNonZeros;
+		if(loopSystem)
+			stats.bytes += loopSystem->getBytes();
         //Atualiza os componentes
-        updateComponents(I.getCol(0));
+        updateComponents(currents);
 	}
 
 	double Circuit::getVoltage(std::string l) {
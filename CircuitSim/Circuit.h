@@ -16,12 +16,124 @@
 
 #include "Graph.h"
 #include "Component.h"
+#include "Iterative.h"
 
 #include <vector>
 #include <string>
+#include <utility>
+#include <memory>
+#include <ostream>
 
 namespace CCT{
 
+   /*************************************************************************
+    * Circuito fundamental em forma esparsa.
+    *
+    * Cada par guarda uma aresta do ciclo e o sentido (1 ou -1) em que ela é
+    * percorrida.
+    *************************************************************************/
+	typedef std::vector<std::pair<unsigned int, int>> signedLoop;
+
+
+   /*************************************************************************
+    * Fornece uma identificação para o caminho seguido por uma solução do
+    * sistema das malhas.
+    *************************************************************************/
+	enum solvePath {
+		NO_LOOPS_PATH, /**< O circuito não tem malhas; nenhum sistema foi resolvido.*/
+		MATRIX_FREE_PATH, /**< Gradiente conjugado sobre o operador, sem montar B*Z*Bt.*/
+		ASSEMBLY_PATH, /**< B*Z*Bt foi montada e o sistema fatorado.*/
+		UPDATE_PATH, /**< A fatoração em cache foi atualizada por resistências editadas.*/
+		CACHED_PATH /**< Apenas as fontes mudaram: a fatoração em cache foi reaproveitada.*/
+	};
+
+
+   /*************************************************************************
+    * Fornece uma identificação para a base de malhas usada na análise.
+    *
+    * Qualquer base do espaço de ciclos dá a mesma solução; bases com malhas
+    * mais curtas tornam B e B*Z*Bt mais esparsas.
+    *************************************************************************/
+	enum loopBasis {
+		BFS_BASIS, /**< Ciclos fundamentais da árvore de busca em largura a partir do vértice 0.*/
+		CENTRAL_BFS_BASIS, /**< Ciclos fundamentais da árvore de busca em largura a partir do centro de cada componente.*/
+		LOW_STRETCH_BASIS, /**< Ciclos fundamentais de uma árvore de baixo estiramento.*/
+		SHORT_CYCLE_BASIS /**< Base de ciclos curtos escolhidos por eliminação sobre GF(2) (não fundamental).*/
+	};
+
+
+   /*************************************************************************
+    * Declaração da estrutura SolveStats.
+    *
+    * Estatísticas da última chamada de Circuit::initialize: tempo de cada
+    * fase (em segundos; zero para as fases que não foram executadas),
+    * dimensões do grafo e do sistema das malhas, resultado do solver e
+    * memória mantida pelo circuito.
+    *************************************************************************/
+	struct SolveStats {
+		double spanningTreeTime; /**< Construção da árvore geradora.*/
+		double loopsTime; /**< Extração dos circuitos fundamentais.*/
+		double assemblyTime; /**< Montagem do lado direito e de B*Z*Bt.*/
+		double factorizationTime; /**< Análise simbólica e fatoração do sistema das malhas.*/
+		double solveTime; /**< Substituições ou iterações do solver, sem a fatoração.*/
+		double updateTime; /**< Atualização da fatoração pelas resistências editadas.*/
+		double totalTime; /**< Tempo total de initialize.*/
+		unsigned int vertices; /**< Número de vértices do grafo.*/
+		unsigned int edges; /**< Número de arestas (componentes) do grafo.*/
+		unsigned int loops; /**< Número de malhas (dimensão do sistema).*/
+		std::size_t loopLength; /**< Soma dos comprimentos das malhas (entradas de B).*/
+		std::size_t nonZeros; /**< Entradas de B*Z*Bt (contadas sem montá-la no caminho sem montagem).*/
+		solvePath path; /**< Caminho seguido pela solução.*/
+		NM::solverMethod method; /**< Método que produziu a solução.*/
+		unsigned int iterations; /**< Iterações do solver.*/
+		double residual; /**< Resíduo relativo final.*/
+		bool converged; /**< Indica se a tolerância foi atingida.*/
+		std::size_t bytes; /**< Memória mantida pelo circuito: malhas, sistema em cache e buffers.*/
+		loopBasis basis; /**< Base de malhas em uso.*/
+	};
+
+
+   /*************************************************************************
+    * Converte as estatísticas de uma solução para JSON.
+    *
+    * @param s Estatísticas.
+    *
+    * @return Objeto JSON em uma única linha, sem a quebra de linha final.
+    *************************************************************************/
+	std::string toJson(const SolveStats &s);
+
+
+   /*************************************************************************
+    * Declaração da classe LoopOperator.
+    *
+    * Aplica a matriz da análise de malhas, A = B*Z*Bt, sem montá-la: o vetor
+    * de correntes de malha é levado às correntes de ramo (Bt), escalado pelas
+    * resistências (Z) e somado de volta em cada malha (B). O custo de cada
+    * aplicação é proporcional ao comprimento total dos ciclos.
+    *************************************************************************/
+	class LoopOperator : public NM::LinearOperator {
+	private:
+		const std::vector<signedLoop> &loops; /**< Circuitos fundamentais (linhas de B).*/
+		const std::vector<double> &resistances; /**< Resistências dos ramos (diagonal de Z).*/
+		mutable std::vector<double> branch; /**< Correntes de ramo da última aplicação.*/
+
+	public:
+	   /******************************************************************************************
+        * Construtor da classe LoopOperator.
+        *
+        * Os vetores são referenciados, e devem existir enquanto o operador for usado.
+        *
+        * @param l Circuitos fundamentais do circuito.
+        * @param r Resistências de cada ramo.
+	 	******************************************************************************************/
+		LoopOperator(const std::vector<signedLoop> &l, const std::vector<double> &r);
+
+		unsigned int getSize() const override;
+		void apply(const double *x, double *y) const override;
+		void getDiagonal(double *d) const override;
+	};
+
+
    /*************************************************************************
     * Declaração da classe Circuit.
     *
@@ -32,8 +144,30 @@ namespace CCT{
 
 	private:
         std::vector<CMP::Component*> components;  /**< Armazena os componentes inseridos.*/
-		std::vector<std::vector<int>> circuitMatrix; /**< Armazena os circuitos fundamentais do grafo.*/
+		std::vector<signedLoop> circuitMatrix; /**< Armazena os circuitos fundamentais do grafo.*/
 		std::vector<unsigned int> chords; /**< Armazena as arestas que não estão na árvore geradora do grafo.*/
+		std::unique_ptr<NM::EquationSystem> loopSystem; /**< Sistema das malhas, com a fatoração em cache.*/
+		bool topologyChanged; /**< Indica se componentes foram inseridos ou removidos desde a última inicialização.*/
+		bool resistancesChanged; /**< Indica se a matriz das malhas deve ser remontada na próxima solução.*/
+		std::vector<std::pair<unsigned int, double>> resistanceUpdates; /**< Variações de resistência (aresta, delta) ainda não aplicadas ao sistema.*/
+
+		//  Memória reaproveitada entre soluções: depois da primeira solução de uma topologia,
+		//as seguintes não alocam.
+		std::vector<double> resistances; /**< Resistências dos ramos, que formam a diagonal da matriz de impedância.*/
+		std::vector<double> voltages; /**< Fontes de tensão de cada ramo.*/
+		std::vector<double> currents; /**< Correntes de cada ramo.*/
+		NM::Matrix rhs; /**< Lado direito B*Vin do sistema das malhas.*/
+		NM::Matrix loopCurrents; /**< Correntes de malha (solução do sistema).*/
+		NM::Matrix updateVectors; /**< Colunas de B das resistências editadas.*/
+		std::vector<double> updateDeltas; /**< Variações das resistências editadas.*/
+		LoopOperator loopOperator; /**< Operador B*Z*Bt sobre circuitMatrix e resistances.*/
+		NM::JacobiPreconditioner jacobi; /**< Precondicionador do gradiente conjugado sem montagem.*/
+		NM::Workspace workspace; /**< Memória de trabalho do gradiente conjugado sem montagem.*/
+		NM::Arena arena; /**< Memória dos temporários da montagem de B*Z*Bt, devolvida ao fim de cada solução.*/
+		std::size_t loopNonZeros; /**< Entradas da última matriz B*Z*Bt montada.*/
+		SolveStats stats; /**< Estatísticas da última inicialização.*/
+		std::ostream *statsStream; /**< Destino das estatísticas em linhas JSON (nulo se desativado).*/
+		loopBasis basis; /**< Base de malhas usada por findLoops.*/
 
 	   /******************************************************************************************
         * Atualiza os valores dos componentes contidos em um objeto da classe Circuit.
@@ -44,13 +178,53 @@ namespace CCT{
         * @param currents um vector contendo os novos valores para as correntes dos componentes.
         * @return void.
 	 	******************************************************************************************/
-        void updateComponents(std:: vector<double> currents);
+        void updateComponents(const std::vector<double> &currents);
 		
 
+       /******************************************************************************************
+        * Obtém os circuitos fundamentais do grafo.
+        *
+        * Descarta as malhas anteriores, constrói a árvore geradora e guarda, para cada aresta
+		* fora dela, a corda em chords e o ciclo fundamental em circuitMatrix. Com
+		* SHORT_CYCLE_BASIS, circuitMatrix recebe a base de ciclos curtos, com o mesmo número
+		* de malhas.
+		*
+        * @return void.
+	 	******************************************************************************************/
+		void findLoops();
+
+
+       /******************************************************************************************
+        * Monta a matriz das malhas.
+        *
+        * Monta B*Z*Bt a partir de circuitMatrix e resistances e a entrega ao sistema em cache
+		* (ou cria o sistema), descartando a fatoração anterior.
+		*
+        * @return void.
+	 	******************************************************************************************/
+		void assembleLoopSystem();
+
+
+       /******************************************************************************************
+        * Conta as entradas de B*Z*Bt sem montá-la.
+        *
+        * Usada no caminho sem montagem, para que as estatísticas tragam o número de entradas
+		* da matriz das malhas também nos circuitos grandes. O resultado fica em loopNonZeros.
+		*
+        * @return void.
+	 	******************************************************************************************/
+		void countLoopNonZeros();
+
+
        /******************************************************************************************
         * Resolve o circuito.
         *
-        * Obtém os valores das correntes em cada componente e atualiza cada componente.
+        * Obtém os valores das correntes em cada componente e atualiza cada componente. Se
+		* apenas fontes foram alteradas desde a última solução, a fatoração em cache é
+		* reaproveitada e somente as substituições são refeitas. Resistências editadas
+		* alteram B*Z*Bt por termos de posto um, aplicados diretamente sobre a fatoração;
+		* se o sistema recusar a atualização, ou se a solução atualizada não atingir a
+		* tolerância, a matriz é remontada.
 		*
         * @return void.
 	 	******************************************************************************************/
@@ -80,17 +254,54 @@ namespace CCT{
         * Obtém os circuitos fundamentais do grafo de circuito e armazena em circuitMAtrix, bem
 		* como, atualiza o vector chords contendo as arestas que não estão contidas na árvore 
 		* geradora do grafo e após isso, resolve o circuito e atualiza os valores de cada 
-		* componente.
+		* componente. Os circuitos fundamentais só são recalculados se a topologia mudou.
 		*
 	 	* @return void
 	 	******************************************************************************************/
 		void initialize();
 
 
+	   /******************************************************************************************
+        * Getter para as estatísticas da última inicialização.
+		*
+	 	* @return Tempos por fase, dimensões, resultado do solver e memória.
+	 	******************************************************************************************/
+		const SolveStats &getStats() const;
+
+
+	   /******************************************************************************************
+        * Ativa a emissão das estatísticas.
+        *
+        * A cada inicialização, as estatísticas são escritas em out como uma linha JSON (ver
+		* toJson). O stream deve existir enquanto estiver ativo.
+		*
+        * @param out Destino das linhas, ou nullptr para desativar a emissão.
+		*
+	 	* @return void
+	 	******************************************************************************************/
+		void setStatsStream(std::ostream *out);
+
+
+	   /******************************************************************************************
+        * Escolhe a base de malhas.
+        *
+        * As malhas são recalculadas na próxima inicialização.
+		*
+        * @param b Base de malhas (BFS_BASIS por padrão).
+		*
+	 	* @return void
+	 	******************************************************************************************/
+		void setLoopBasis(loopBasis b);
+
+		loopBasis getLoopBasis() const; /**< Retorna a base de malhas em uso.*/
+
+
 	   /******************************************************************************************
         * Reseta a matriz de circuitos fundamentais.
         *
-        * Remove todos os elementos contidss do vector cicuitMatrix e do vector chords.
+        * Remove todos os elementos contidss do vector cicuitMatrix e do vector chords, bem
+		* como o sistema em cache, caso a topologia do circuito tenha mudado. Edições apenas de
+		* valores preservam os circuitos fundamentais e a fatoração.
 		*
         * @return Void.
 	 	******************************************************************************************/
@@ -119,7 +330,8 @@ namespace CCT{
 		* Edita o valor de um objeto da classe Component pertencente ao circuito.
 		*
 		* Caso o componente esteja no circuito, altera o valor relacionado ao componente 
-        * (resistência/tensão) cujo nome de identificação é l.
+        * (resistência/tensão) cujo nome de identificação é l. A variação de uma resistência
+        * é guardada para atualizar a fatoração em cache na próxima solução.
 		* 
         * @param value Novo valor do componente a ser editado.
         * @param label Nome de identificação do componente a ser editado.
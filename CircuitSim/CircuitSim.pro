@@ -1,25 +1,48 @@
 TEMPLATE = app
 TARGET = CircuitSim
 QT = core gui widgets
+CONFIG += c++17
+
+# BLAS/LAPACK do sistema, se encontrada pelo pkg-config: habilita o backend BLAS do NM
+# (ver Backend.h). Sem ela, apenas o backend embutido é compilado.
+CONFIG += link_pkgconfig
+packagesExist(openblas) {
+    PKGCONFIG += openblas
+    DEFINES += NM_USE_BLAS
+} else:packagesExist(blas lapack) {
+    PKGCONFIG += blas lapack
+    DEFINES += NM_USE_BLAS
+}
 
 SOURCES += \
+    Backend.cpp \
     Circuit.cpp \
     Component.cpp \
     Diagram.cpp \
+    Gemm.cpp \
     Graph.cpp \
     GraphicComponent.cpp \
+    Iterative.cpp \
     MainWindow.cpp \
     Numeric.cpp \
+    Planner.cpp \
+    ThreadPool.cpp \
     main.cpp
 
 HEADERS += \
+    Backend.h \
     Circuit.h \
     Component.h \
     Diagram.h \
+    FixedMatrix.h \
+    Gemm.h \
     Graph.h \
     GraphicComponent.h \
+    Iterative.h \
     MainWindow.h \
-    Numeric.h
+    Numeric.h \
+    Planner.h \
+    ThreadPool.h
 
 RESOURCES += \
     Resources.qrc
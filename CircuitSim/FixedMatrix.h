@@ -0,0 +1,358 @@
+/********************************************************************************************
+ * @file FixedMatrix.h
+ * @authors: Lucas Carvalho; Rafael Marasca Martins
+ * @date: 18 10 2026
+ * @brief Declaração e implementação da classe FixedMatrix.
+ *
+ * Este arquivo contém a matriz de dimensões fixas em tempo de compilação, usada pelos
+ * sistemas pequenos (subcircuitos com poucas malhas).
+ *
+ * Os elementos ficam na própria matriz (na pilha, quando ela é uma variável local), de modo
+ * que nenhuma operação aloca memória, e os laços têm limites constantes, desenrolados pelo
+ * compilador.
+ *
+ ********************************************************************************************/
+
+#ifndef FIXEDMATRIX_H
+#define FIXEDMATRIX_H
+
+#include "Numeric.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <string>
+
+//  Pede o desenrolamento completo dos laços de limites constantes.
+#if defined(__clang__)
+#define NM_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__)
+#define NM_UNROLL _Pragma("GCC unroll 16")
+#else
+#define NM_UNROLL
+#endif
+
+namespace NM {
+
+   /*************************************************************************
+    * Declaração da classe FixedMatrix.
+    *
+    * Matriz R x C de dimensões constantes, armazenada por linhas em um
+    * std::array. Oferece as operações aritméticas básicas e a solução de
+    * sistemas quadrados pela fatoração LU com pivoteamento parcial.
+    *************************************************************************/
+	template <unsigned int R, unsigned int C>
+	class FixedMatrix {
+	private:
+		std::array<double, R * C> elements; /**< Elementos da matriz, armazenados por linhas.*/
+
+	public:
+	   /*************************************************************************
+    	* Construtor da classe FixedMatrix.
+    	*
+    	* Constrói a matriz nula.
+    	*************************************************************************/
+		FixedMatrix() : elements{} {}
+
+	   /*************************************************************************
+    	* Construtor da classe FixedMatrix.
+    	*
+    	* Copia os elementos de uma visão de mesmas dimensões.
+    	*
+    	* @param v Visão cujos elementos serão copiados.
+		*
+    	* @overload
+    	*************************************************************************/
+		explicit FixedMatrix(const ConstMatrixView &v) {
+			if(v.getRowNumber() != R or v.getColNumber() != C)
+				throw std::string("Matrizes incompativeis.");
+			NM_UNROLL
+			for(unsigned int i = 0; i < R; i++)
+				NM_UNROLL
+				for(unsigned int j = 0; j < C; j++)
+					(*this)(i, j) = v(i, j);
+		}
+
+	   /*************************************************************************
+    	* Construtor da classe FixedMatrix.
+    	*
+    	* Copia os elementos de uma matriz de mesmas dimensões.
+    	*
+    	* @param m Matriz cujos elementos serão copiados.
+		*
+    	* @overload
+    	*************************************************************************/
+		explicit FixedMatrix(const Matrix &m) : FixedMatrix(m.view()) {}
+
+		static constexpr unsigned int getRowNumber() { return R; } /**< Retorna o número de linhas.*/
+		static constexpr unsigned int getColNumber() { return C; } /**< Retorna o número de colunas.*/
+
+	   /*************************************************************************
+    	* Acesso sem verificação de limites.
+    	*
+    	* @param i Linha.
+    	* @param j Coluna.
+		*
+    	* @return Referência ao elemento (i, j).
+    	*************************************************************************/
+		double &operator() (unsigned int i, unsigned int j) { return elements[i * C + j]; }
+		const double &operator() (unsigned int i, unsigned int j) const { return elements[i * C + j]; }
+
+	   /*************************************************************************
+    	* Visão dos elementos, para uso com as funções de NM que recebem visões.
+    	*
+    	* @return Visão da matriz inteira.
+    	*************************************************************************/
+		MatrixView view() { return MatrixView(elements.data(), R, C, C, 1); }
+		ConstMatrixView view() const { return ConstMatrixView(elements.data(), R, C, C, 1); }
+
+	   /*************************************************************************
+    	* Conversão para NM::Matrix.
+    	*
+    	* @return Matriz com os mesmos elementos.
+    	*************************************************************************/
+		Matrix toMatrix() const { return Matrix(view()); }
+
+	   /*************************************************************************
+    	* Copia os elementos para uma matriz existente.
+    	*
+    	* Não aloca memória se m já tiver as dimensões R x C.
+    	*
+    	* @param m Matriz de destino.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void copyTo(Matrix &m) const {
+			if(m.getRowNumber() != R or m.getColNumber() != C)
+				m = Matrix(R, C);
+			MatrixView v = m.view();
+			NM_UNROLL
+			for(unsigned int i = 0; i < R; i++)
+				NM_UNROLL
+				for(unsigned int j = 0; j < C; j++)
+					v(i, j) = (*this)(i, j);
+		}
+
+	   /*************************************************************************
+    	* Matriz transposta.
+    	*
+    	* @return Transposta C x R.
+    	*************************************************************************/
+		FixedMatrix<C, R> transpose() const {
+			FixedMatrix<C, R> t;
+			NM_UNROLL
+			for(unsigned int i = 0; i < R; i++)
+				NM_UNROLL
+				for(unsigned int j = 0; j < C; j++)
+					t(j, i) = (*this)(i, j);
+			return t;
+		}
+
+	   /*************************************************************************
+    	* Sobrecarga dos operadores += e -= da classe FixedMatrix.
+    	*
+    	* @param m Matriz de mesmas dimensões.
+		*
+    	* @return Referência a esta matriz.
+    	*************************************************************************/
+		FixedMatrix &operator+= (const FixedMatrix &m) {
+			NM_UNROLL
+			for(unsigned int k = 0; k < R * C; k++)
+				elements[k] += m.elements[k];
+			return *this;
+		}
+		FixedMatrix &operator-= (const FixedMatrix &m) {
+			NM_UNROLL
+			for(unsigned int k = 0; k < R * C; k++)
+				elements[k] -= m.elements[k];
+			return *this;
+		}
+
+	   /*************************************************************************
+    	* Sobrecarga do operador *= da classe FixedMatrix.
+    	*
+    	* @param alpha Escalar.
+		*
+    	* @return Referência a esta matriz.
+    	*************************************************************************/
+		FixedMatrix &operator*= (double alpha) {
+			NM_UNROLL
+			for(unsigned int k = 0; k < R * C; k++)
+				elements[k] *= alpha;
+			return *this;
+		}
+
+		FixedMatrix operator+ (const FixedMatrix &m) const { return FixedMatrix(*this) += m; } /**< Soma de matrizes.*/
+		FixedMatrix operator- (const FixedMatrix &m) const { return FixedMatrix(*this) -= m; } /**< Diferença de matrizes.*/
+		FixedMatrix operator* (double alpha) const { return FixedMatrix(*this) *= alpha; } /**< Produto por escalar.*/
+
+	   /*************************************************************************
+    	* Sobrecarga do operador * da classe FixedMatrix.
+    	*
+    	* Produto de matrizes; as dimensões internas são verificadas em tempo de
+		* compilação.
+    	*
+    	* @param m Matriz C x K.
+		*
+    	* @return Produto R x K.
+    	*************************************************************************/
+		template <unsigned int K>
+		FixedMatrix<R, K> operator* (const FixedMatrix<C, K> &m) const {
+			FixedMatrix<R, K> p;
+			NM_UNROLL
+			for(unsigned int i = 0; i < R; i++) {
+				NM_UNROLL
+				for(unsigned int k = 0; k < C; k++) {
+					const double a = (*this)(i, k);
+					NM_UNROLL
+					for(unsigned int j = 0; j < K; j++)
+						p(i, j) += a * m(k, j);
+				}
+			}
+			return p;
+		}
+
+	   /*************************************************************************
+    	* Fatoração LU com pivoteamento parcial, sobre a própria matriz.
+    	*
+    	* As linhas são trocadas fisicamente; perm[i] guarda a linha original
+		* que ocupa a posição i. Como em LUDecomposition, uma coluna sem pivô
+		* é deixada de lado e a incógnita correspondente será nula. Um pivô
+		* que não passa de R*eps*max|a(i, j)| é resíduo de arredondamento de
+		* uma coluna dependente das anteriores, e também é descartado.
+    	*
+    	* @param perm Permutação das linhas (saída).
+		*
+    	* @return true se a matriz é regular.
+    	*************************************************************************/
+		bool factorizeLU(std::array<unsigned int, R> &perm) {
+			static_assert(R == C, "A fatoracao LU exige uma matriz quadrada.");
+			bool regular = true;
+
+			double scale = 0;
+			NM_UNROLL
+			for(unsigned int k = 0; k < R * C; k++)
+				scale = std::max(scale, std::fabs(elements[k]));
+			const double negligible = R * std::numeric_limits<double>::epsilon() * scale;
+
+			NM_UNROLL
+			for(unsigned int i = 0; i < R; i++)
+				perm[i] = i;
+
+			NM_UNROLL
+			for(unsigned int k = 0; k < R; k++) {
+				unsigned int index = k;
+				double biggest = std::fabs((*this)(k, k));
+				for(unsigned int i = k + 1; i < R; i++) {
+					if(std::fabs((*this)(i, k)) > biggest) {
+						biggest = std::fabs((*this)(i, k));
+						index = i;
+					}
+				}
+
+				if(biggest <= negligible) {
+					regular = false;
+					for(unsigned int i = k; i < R; i++)
+						(*this)(i, k) = 0;
+					continue;
+				}
+
+				if(index != k) {
+					std::swap(perm[k], perm[index]);
+					NM_UNROLL
+					for(unsigned int j = 0; j < C; j++)
+						std::swap((*this)(k, j), (*this)(index, j));
+				}
+
+				const double pivot = (*this)(k, k);
+				for(unsigned int i = k + 1; i < R; i++) {
+					const double mult = (*this)(i, k) / pivot;
+					(*this)(i, k) = mult;
+					for(unsigned int j = k + 1; j < C; j++)
+						(*this)(i, j) -= mult * (*this)(k, j);
+				}
+			}
+			return regular;
+		}
+
+	   /*************************************************************************
+    	* Resolve um sistema a partir de uma fatoração de factorizeLU.
+    	*
+    	* @param perm Permutação retornada pela fatoração.
+    	* @param b Constantes (entrada), substituídas pela solução (saída).
+		*
+    	* @return Void.
+    	*************************************************************************/
+		template <unsigned int M>
+		void solveLU(const std::array<unsigned int, R> &perm, FixedMatrix<R, M> &b) const {
+			static_assert(R == C, "A fatoracao LU exige uma matriz quadrada.");
+			FixedMatrix<R, M> y;
+
+			NM_UNROLL
+			for(unsigned int i = 0; i < R; i++)
+				NM_UNROLL
+				for(unsigned int c = 0; c < M; c++)
+					y(i, c) = b(perm[i], c);
+
+			//  Substituição direta com L (diagonal unitária).
+			NM_UNROLL
+			for(unsigned int i = 1; i < R; i++)
+				for(unsigned int j = 0; j < i; j++)
+					NM_UNROLL
+					for(unsigned int c = 0; c < M; c++)
+						y(i, c) -= (*this)(i, j) * y(j, c);
+
+			//  Substituição reversa com U. Pivôs nulos levam a incógnita a zero.
+			NM_UNROLL
+			for(unsigned int r = 0; r < R; r++) {
+				const unsigned int i = R - 1 - r;
+				const double pivot = (*this)(i, i);
+				NM_UNROLL
+				for(unsigned int c = 0; c < M; c++) {
+					if(pivot == 0) {
+						y(i, c) = 0;
+						continue;
+					}
+					for(unsigned int j = i + 1; j < R; j++)
+						y(i, c) -= (*this)(i, j) * y(j, c);
+					y(i, c) /= pivot;
+				}
+			}
+			b = y;
+		}
+
+	   /*************************************************************************
+    	* Resolve o sistema (*this)*x = b.
+    	*
+    	* Fatora uma cópia da matriz; para várias soluções com a mesma matriz,
+		* use factorizeLU e solveLU.
+    	*
+    	* @param b Constantes (entrada), substituídas pela solução (saída).
+		*
+    	* @return true se a matriz é regular.
+    	*************************************************************************/
+		template <unsigned int M>
+		bool solve(FixedMatrix<R, M> &b) const {
+			FixedMatrix lu(*this);
+			std::array<unsigned int, R> perm;
+			const bool regular = lu.factorizeLU(perm);
+			lu.solveLU(perm, b);
+			return regular;
+		}
+	};
+
+
+   /*************************************************************************
+    * Produto de um escalar por uma FixedMatrix.
+    *
+    * @param alpha Escalar.
+    * @param m Matriz.
+	*
+    * @return alpha*m.
+    *************************************************************************/
+	template <unsigned int R, unsigned int C>
+	FixedMatrix<R, C> operator* (double alpha, const FixedMatrix<R, C> &m) { return m * alpha; }
+}
+
+#endif
@@ -0,0 +1,374 @@
+/********************************************************************************************
+ * @file Gemm.cpp
+ * @authors: Lucas Carvalho; Rafael Marasca Martins
+ * @date: 18 10 2026
+ * @brief Implementação do núcleo de multiplicação de matrizes densas.
+ *
+ * Este arquivo contém a multiplicação blocada de matrizes, o empacotamento dos operandos e
+ * os micronúcleos escalar, AVX2 e AVX-512, em precisão dupla e simples.
+ *
+ ********************************************************************************************/
+
+#include "Gemm.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+//  Os micronúcleos vetoriais só são compilados para x86 com GCC/Clang, que permitem gerar
+//código de um conjunto de instruções por função e consultar o processador em tempo de
+//execução. Nos demais ambientes apenas o micronúcleo escalar é usado.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NM_GEMM_X86
+#include <immintrin.h>
+#endif
+
+namespace NM {
+
+	//  Dimensões dos blocos: um painel de B (KC x NR) fica na L1, o bloco empacotado de A
+	//(MC x KC, 256 KiB) na L2 e o bloco de B (KC x NC, 4 MiB) na L3. MC é múltiplo das
+	//alturas de todos os micronúcleos.
+	static const unsigned int KC = 256;
+	static const unsigned int MC = 128;
+	static const unsigned int NC = 2048;
+
+	//  Um micronúcleo calcula C += alpha*Ap*Bp para um painel de MR linhas de A e NR colunas
+	//de B, ambos empacotados com kc passos. C é um bloco MR x NR de linhas contíguas, 
+	//separadas por ldc elementos.
+	template <typename T>
+	struct KernelInfo {
+		gemmKernel id; /**< Identificação do micronúcleo.*/
+		unsigned int mr; /**< Linhas do bloco de registradores.*/
+		unsigned int nr; /**< Colunas do bloco de registradores.*/
+		void (*run)(unsigned int kc, const T *a, const T *b, T *c, std::ptrdiff_t ldc, T alpha); /**< Função do micronúcleo.*/
+	};
+
+	template <typename T, unsigned int MR, unsigned int NR>
+	static void scalarKernel(unsigned int kc, const T *a, const T *b, T *c, std::ptrdiff_t ldc, T alpha) {
+		T acc[MR][NR] = {};
+		for(unsigned int k = 0; k < kc; k++, a += MR, b += NR)
+			for(unsigned int r = 0; r < MR; r++)
+				for(unsigned int q = 0; q < NR; q++)
+					acc[r][q] += a[r] * b[q];
+
+		for(unsigned int r = 0; r < MR; r++)
+			for(unsigned int q = 0; q < NR; q++)
+				c[r * ldc + q] += alpha * acc[r][q];
+	}
+
+#ifdef NM_GEMM_X86
+	//  4x8: duas cargas de B e quatro difusões de A alimentam oito FMAs por passo.
+	__attribute__((target("avx2,fma")))
+	static void avx2Kernel(unsigned int kc, const double *a, const double *b, double *c, std::ptrdiff_t ldc, double alpha) {
+		__m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+		__m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+		__m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+		__m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+
+		for(unsigned int k = 0; k < kc; k++, a += 4, b += 8) {
+			const __m256d b0 = _mm256_loadu_pd(b);
+			const __m256d b1 = _mm256_loadu_pd(b + 4);
+			__m256d ak = _mm256_broadcast_sd(a);
+			c00 = _mm256_fmadd_pd(ak, b0, c00);
+			c01 = _mm256_fmadd_pd(ak, b1, c01);
+			ak = _mm256_broadcast_sd(a + 1);
+			c10 = _mm256_fmadd_pd(ak, b0, c10);
+			c11 = _mm256_fmadd_pd(ak, b1, c11);
+			ak = _mm256_broadcast_sd(a + 2);
+			c20 = _mm256_fmadd_pd(ak, b0, c20);
+			c21 = _mm256_fmadd_pd(ak, b1, c21);
+			ak = _mm256_broadcast_sd(a + 3);
+			c30 = _mm256_fmadd_pd(ak, b0, c30);
+			c31 = _mm256_fmadd_pd(ak, b1, c31);
+		}
+
+		const __m256d va = _mm256_set1_pd(alpha);
+		_mm256_storeu_pd(c, _mm256_fmadd_pd(va, c00, _mm256_loadu_pd(c)));
+		_mm256_storeu_pd(c + 4, _mm256_fmadd_pd(va, c01, _mm256_loadu_pd(c + 4)));
+		c += ldc;
+		_mm256_storeu_pd(c, _mm256_fmadd_pd(va, c10, _mm256_loadu_pd(c)));
+		_mm256_storeu_pd(c + 4, _mm256_fmadd_pd(va, c11, _mm256_loadu_pd(c + 4)));
+		c += ldc;
+		_mm256_storeu_pd(c, _mm256_fmadd_pd(va, c20, _mm256_loadu_pd(c)));
+		_mm256_storeu_pd(c + 4, _mm256_fmadd_pd(va, c21, _mm256_loadu_pd(c + 4)));
+		c += ldc;
+		_mm256_storeu_pd(c, _mm256_fmadd_pd(va, c30, _mm256_loadu_pd(c)));
+		_mm256_storeu_pd(c + 4, _mm256_fmadd_pd(va, c31, _mm256_loadu_pd(c + 4)));
+	}
+
+	//  8x8: uma carga de B e oito difusões de A alimentam oito FMAs independentes por passo.
+	__attribute__((target("avx512f")))
+	static void avx512Kernel(unsigned int kc, const double *a, const double *b, double *c, std::ptrdiff_t ldc, double alpha) {
+		__m512d c0 = _mm512_setzero_pd(), c1 = _mm512_setzero_pd();
+		__m512d c2 = _mm512_setzero_pd(), c3 = _mm512_setzero_pd();
+		__m512d c4 = _mm512_setzero_pd(), c5 = _mm512_setzero_pd();
+		__m512d c6 = _mm512_setzero_pd(), c7 = _mm512_setzero_pd();
+
+		for(unsigned int k = 0; k < kc; k++, a += 8, b += 8) {
+			const __m512d bk = _mm512_loadu_pd(b);
+			c0 = _mm512_fmadd_pd(_mm512_set1_pd(a[0]), bk, c0);
+			c1 = _mm512_fmadd_pd(_mm512_set1_pd(a[1]), bk, c1);
+			c2 = _mm512_fmadd_pd(_mm512_set1_pd(a[2]), bk, c2);
+			c3 = _mm512_fmadd_pd(_mm512_set1_pd(a[3]), bk, c3);
+			c4 = _mm512_fmadd_pd(_mm512_set1_pd(a[4]), bk, c4);
+			c5 = _mm512_fmadd_pd(_mm512_set1_pd(a[5]), bk, c5);
+			c6 = _mm512_fmadd_pd(_mm512_set1_pd(a[6]), bk, c6);
+			c7 = _mm512_fmadd_pd(_mm512_set1_pd(a[7]), bk, c7);
+		}
+
+		const __m512d va = _mm512_set1_pd(alpha);
+		_mm512_storeu_pd(c, _mm512_fmadd_pd(va, c0, _mm512_loadu_pd(c)));
+		_mm512_storeu_pd(c + ldc, _mm512_fmadd_pd(va, c1, _mm512_loadu_pd(c + ldc)));
+		_mm512_storeu_pd(c + 2 * ldc, _mm512_fmadd_pd(va, c2, _mm512_loadu_pd(c + 2 * ldc)));
+		_mm512_storeu_pd(c + 3 * ldc, _mm512_fmadd_pd(va, c3, _mm512_loadu_pd(c + 3 * ldc)));
+		_mm512_storeu_pd(c + 4 * ldc, _mm512_fmadd_pd(va, c4, _mm512_loadu_pd(c + 4 * ldc)));
+		_mm512_storeu_pd(c + 5 * ldc, _mm512_fmadd_pd(va, c5, _mm512_loadu_pd(c + 5 * ldc)));
+		_mm512_storeu_pd(c + 6 * ldc, _mm512_fmadd_pd(va, c6, _mm512_loadu_pd(c + 6 * ldc)));
+		_mm512_storeu_pd(c + 7 * ldc, _mm512_fmadd_pd(va, c7, _mm512_loadu_pd(c + 7 * ldc)));
+	}
+
+	//  Precisão simples, 4x16: cada registrador guarda o dobro de elementos.
+	__attribute__((target("avx2,fma")))
+	static void avx2FloatKernel(unsigned int kc, const float *a, const float *b, float *c, std::ptrdiff_t ldc, float alpha) {
+		__m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+		__m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+		__m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+		__m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+
+		for(unsigned int k = 0; k < kc; k++, a += 4, b += 16) {
+			const __m256 b0 = _mm256_loadu_ps(b);
+			const __m256 b1 = _mm256_loadu_ps(b + 8);
+			__m256 ak = _mm256_broadcast_ss(a);
+			c00 = _mm256_fmadd_ps(ak, b0, c00);
+			c01 = _mm256_fmadd_ps(ak, b1, c01);
+			ak = _mm256_broadcast_ss(a + 1);
+			c10 = _mm256_fmadd_ps(ak, b0, c10);
+			c11 = _mm256_fmadd_ps(ak, b1, c11);
+			ak = _mm256_broadcast_ss(a + 2);
+			c20 = _mm256_fmadd_ps(ak, b0, c20);
+			c21 = _mm256_fmadd_ps(ak, b1, c21);
+			ak = _mm256_broadcast_ss(a + 3);
+			c30 = _mm256_fmadd_ps(ak, b0, c30);
+			c31 = _mm256_fmadd_ps(ak, b1, c31);
+		}
+
+		const __m256 va = _mm256_set1_ps(alpha);
+		_mm256_storeu_ps(c, _mm256_fmadd_ps(va, c00, _mm256_loadu_ps(c)));
+		_mm256_storeu_ps(c + 8, _mm256_fmadd_ps(va, c01, _mm256_loadu_ps(c + 8)));
+		c += ldc;
+		_mm256_storeu_ps(c, _mm256_fmadd_ps(va, c10, _mm256_loadu_ps(c)));
+		_mm256_storeu_ps(c + 8, _mm256_fmadd_ps(va, c11, _mm256_loadu_ps(c + 8)));
+		c += ldc;
+		_mm256_storeu_ps(c, _mm256_fmadd_ps(va, c20, _mm256_loadu_ps(c)));
+		_mm256_storeu_ps(c + 8, _mm256_fmadd_ps(va, c21, _mm256_loadu_ps(c + 8)));
+		c += ldc;
+		_mm256_storeu_ps(c, _mm256_fmadd_ps(va, c30, _mm256_loadu_ps(c)));
+		_mm256_storeu_ps(c + 8, _mm256_fmadd_ps(va, c31, _mm256_loadu_ps(c + 8)));
+	}
+
+	//  Precisão simples, 8x16.
+	__attribute__((target("avx512f")))
+	static void avx512FloatKernel(unsigned int kc, const float *a, const float *b, float *c, std::ptrdiff_t ldc, float alpha) {
+		__m512 c0 = _mm512_setzero_ps(), c1 = _mm512_setzero_ps();
+		__m512 c2 = _mm512_setzero_ps(), c3 = _mm512_setzero_ps();
+		__m512 c4 = _mm512_setzero_ps(), c5 = _mm512_setzero_ps();
+		__m512 c6 = _mm512_setzero_ps(), c7 = _mm512_setzero_ps();
+
+		for(unsigned int k = 0; k < kc; k++, a += 8, b += 16) {
+			const __m512 bk = _mm512_loadu_ps(b);
+			c0 = _mm512_fmadd_ps(_mm512_set1_ps(a[0]), bk, c0);
+			c1 = _mm512_fmadd_ps(_mm512_set1_ps(a[1]), bk, c1);
+			c2 = _mm512_fmadd_ps(_mm512_set1_ps(a[2]), bk, c2);
+			c3 = _mm512_fmadd_ps(_mm512_set1_ps(a[3]), bk, c3);
+			c4 = _mm512_fmadd_ps(_mm512_set1_ps(a[4]), bk, c4);
+			c5 = _mm512_fmadd_ps(_mm512_set1_ps(a[5]), bk, c5);
+			c6 = _mm512_fmadd_ps(_mm512_set1_ps(a[6]), bk, c6);
+			c7 = _mm512_fmadd_ps(_mm512_set1_ps(a[7]), bk, c7);
+		}
+
+		const __m512 va = _mm512_set1_ps(alpha);
+		_mm512_storeu_ps(c, _mm512_fmadd_ps(va, c0, _mm512_loadu_ps(c)));
+		_mm512_storeu_ps(c + ldc, _mm512_fmadd_ps(va, c1, _mm512_loadu_ps(c + ldc)));
+		_mm512_storeu_ps(c + 2 * ldc, _mm512_fmadd_ps(va, c2, _mm512_loadu_ps(c + 2 * ldc)));
+		_mm512_storeu_ps(c + 3 * ldc, _mm512_fmadd_ps(va, c3, _mm512_loadu_ps(c + 3 * ldc)));
+		_mm512_storeu_ps(c + 4 * ldc, _mm512_fmadd_ps(va, c4, _mm512_loadu_ps(c + 4 * ldc)));
+		_mm512_storeu_ps(c + 5 * ldc, _mm512_fmadd_ps(va, c5, _mm512_loadu_ps(c + 5 * ldc)));
+		_mm512_storeu_ps(c + 6 * ldc, _mm512_fmadd_ps(va, c6, _mm512_loadu_ps(c + 6 * ldc)));
+		_mm512_storeu_ps(c + 7 * ldc, _mm512_fmadd_ps(va, c7, _mm512_loadu_ps(c + 7 * ldc)));
+	}
+#endif
+
+	static const KernelInfo<double> scalarInfo = {SCALAR_KERNEL, 4, 8, scalarKernel<double, 4, 8>};
+	static const KernelInfo<float> scalarFloatInfo = {SCALAR_KERNEL, 4, 8, scalarKernel<float, 4, 8>};
+#ifdef NM_GEMM_X86
+	static const KernelInfo<double> avx2Info = {AVX2_KERNEL, 4, 8, avx2Kernel};
+	static const KernelInfo<double> avx512Info = {AVX512_KERNEL, 8, 8, avx512Kernel};
+	static const KernelInfo<float> avx2FloatInfo = {AVX2_KERNEL, 4, 16, avx2FloatKernel};
+	static const KernelInfo<float> avx512FloatInfo = {AVX512_KERNEL, 8, 16, avx512FloatKernel};
+#endif
+
+	static gemmKernel requestedKernel = AUTOMATIC_KERNEL;
+
+	bool isGemmKernelSupported(gemmKernel k) {
+		switch(k) {
+			case AUTOMATIC_KERNEL:
+			case SCALAR_KERNEL:
+				return true;
+#ifdef NM_GEMM_X86
+			case AVX2_KERNEL:
+				__builtin_cpu_init();
+				return __builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma");
+			case AVX512_KERNEL:
+				__builtin_cpu_init();
+				return __builtin_cpu_supports("avx512f");
+#endif
+			default:
+				return false;
+		}
+	}
+
+	//  A detecção é feita uma única vez; a inicialização de estáticas locais é segura
+	//entre threads.
+	static gemmKernel detectKernel() {
+		static const gemmKernel detected = isGemmKernelSupported(AVX512_KERNEL) ? AVX512_KERNEL :
+		                                   isGemmKernelSupported(AVX2_KERNEL) ? AVX2_KERNEL : SCALAR_KERNEL;
+		return detected;
+	}
+
+	void setGemmKernel(gemmKernel k) {
+		if(not isGemmKernelSupported(k))
+			throw std::string("Micronucleo nao suportado pelo processador");
+		requestedKernel = k;
+	}
+
+	gemmKernel getGemmKernel() { return (requestedKernel == AUTOMATIC_KERNEL) ? detectKernel() : requestedKernel; }
+
+	static const KernelInfo<double> &kernelInfo(double) {
+		switch(getGemmKernel()) {
+#ifdef NM_GEMM_X86
+			case AVX2_KERNEL:
+				return avx2Info;
+			case AVX512_KERNEL:
+				return avx512Info;
+#endif
+			default:
+				return scalarInfo;
+		}
+	}
+
+	static const KernelInfo<float> &kernelInfo(float) {
+		switch(getGemmKernel()) {
+#ifdef NM_GEMM_X86
+			case AVX2_KERNEL:
+				return avx2FloatInfo;
+			case AVX512_KERNEL:
+				return avx512FloatInfo;
+#endif
+			default:
+				return scalarFloatInfo;
+		}
+	}
+
+	//  Empacota um bloco mc x kc de A em painéis de mr linhas: dentro de cada painel, os
+	//mr elementos de uma mesma coluna ficam contíguos. Linhas que faltam no último painel
+	//são preenchidas com zeros.
+	template <typename T>
+	static void packA(const BasicMatrixView<const T> &a, unsigned int mr, T *dst) {
+		const unsigned int mc = a.getRowNumber(), kc = a.getColNumber();
+		for(unsigned int ir = 0; ir < mc; ir += mr, dst += std::size_t(mr) * kc) {
+			const unsigned int rows = std::min(mr, mc - ir);
+			for(unsigned int r = 0; r < rows; r++)
+				for(unsigned int k = 0; k < kc; k++)
+					dst[k * mr + r] = a(ir + r, k);
+			for(unsigned int r = rows; r < mr; r++)
+				for(unsigned int k = 0; k < kc; k++)
+					dst[k * mr + r] = 0;
+		}
+	}
+
+	//  Empacota um bloco kc x nc de B em painéis de nr colunas: dentro de cada painel, os
+	//nr elementos de uma mesma linha ficam contíguos.
+	template <typename T>
+	static void packB(const BasicMatrixView<const T> &b, unsigned int nr, T *dst) {
+		const unsigned int kc = b.getRowNumber(), nc = b.getColNumber();
+		for(unsigned int jr = 0; jr < nc; jr += nr, dst += std::size_t(nr) * kc) {
+			const unsigned int cols = std::min(nr, nc - jr);
+			for(unsigned int k = 0; k < kc; k++) {
+				for(unsigned int c = 0; c < cols; c++)
+					dst[k * nr + c] = b(k, jr + c);
+				for(unsigned int c = cols; c < nr; c++)
+					dst[k * nr + c] = 0;
+			}
+		}
+	}
+
+	//  Algoritmo blocado comum às duas precisões.
+	template <typename T>
+	static void blockedGemm(const BasicMatrixView<const T> &a, const BasicMatrixView<const T> &b, const BasicMatrixView<T> &c, T alpha) {
+		if(a.getColNumber() != b.getRowNumber() or c.getRowNumber() != a.getRowNumber() or c.getColNumber() != b.getColNumber())
+			throw std::string("Matrizes incompativeis.");
+
+		const unsigned int m = c.getRowNumber(), n = c.getColNumber(), p = a.getColNumber();
+		if(m == 0 or n == 0 or p == 0 or alpha == 0)
+			return;
+
+		const KernelInfo<T> &kernel = kernelInfo(T());
+		const unsigned int mr = kernel.mr, nr = kernel.nr;
+
+		//  Os painéis são dimensionados pelos operandos: produtos pequenos não pagam pela 
+		//alocação dos blocos completos.
+		const std::size_t maxMC = (std::min(MC, m) + mr - 1) / mr * mr;
+		const std::size_t maxNC = (std::min(NC, n) + nr - 1) / nr * nr;
+		const std::size_t maxKC = std::min(KC, p);
+
+		std::vector<T, AlignedAllocator<T>> packedA(maxMC * maxKC);
+		std::vector<T, AlignedAllocator<T>> packedB(maxKC * maxNC);
+		std::vector<T, AlignedAllocator<T>> ab(std::size_t(mr) * nr);
+
+		for(unsigned int jc = 0; jc < n; jc += NC) {
+			const unsigned int nc = std::min(NC, n - jc);
+
+			for(unsigned int pc = 0; pc < p; pc += KC) {
+				const unsigned int kc = std::min(KC, p - pc);
+				packB<T>(b.block(pc, jc, kc, nc), nr, packedB.data());
+
+				for(unsigned int ic = 0; ic < m; ic += MC) {
+					const unsigned int mc = std::min(MC, m - ic);
+					packA<T>(a.block(ic, pc, mc, kc), mr, packedA.data());
+
+					for(unsigned int jr = 0; jr < nc; jr += nr) {
+						const unsigned int cols = std::min(nr, nc - jr);
+						const T *bp = packedB.data() + std::size_t(jr) * kc;
+
+						for(unsigned int ir = 0; ir < mc; ir += mr) {
+							const unsigned int rows = std::min(mr, mc - ir);
+							const T *ap = packedA.data() + std::size_t(ir) * kc;
+
+							//  Blocos completos com linhas contíguas são acumulados diretamente
+							//no destino pelo micronúcleo.
+							if(rows == mr and cols == nr and c.getColStride() == 1) {
+								kernel.run(kc, ap, bp, &c(ic + ir, jc + jr), c.getRowStride(), alpha);
+								continue;
+							}
+
+							//  Bordas: o bloco é calculado à parte e somado sem o preenchimento.
+							std::fill(ab.begin(), ab.end(), T(0));
+							kernel.run(kc, ap, bp, ab.data(), nr, T(1));
+							for(unsigned int r = 0; r < rows; r++)
+								for(unsigned int q = 0; q < cols; q++)
+									c(ic + ir + r, jc + jr + q) += alpha * ab[r * nr + q];
+						}
+					}
+				}
+			}
+		}
+	}
+
+	void gemm(const ConstMatrixView &a, const ConstMatrixView &b, const MatrixView &c, double alpha) {
+		blockedGemm<double>(a, b, c, alpha);
+	}
+
+	void gemm(const ConstFloatMatrixView &a, const ConstFloatMatrixView &b, const FloatMatrixView &c, float alpha) {
+		blockedGemm<float>(a, b, c, alpha);
+	}
+}
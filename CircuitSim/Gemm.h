@@ -0,0 +1,101 @@
+/********************************************************************************************
+ * @file Gemm.h
+ * @authors: Lucas Carvalho; Rafael Marasca Martins
+ * @date: 18 10 2026
+ * @brief Declaração do núcleo de multiplicação de matrizes densas.
+ *
+ * Este arquivo contém a declaração da multiplicação blocada de matrizes (GEMM) usada pelos
+ * produtos da classe Matrix.
+ *
+ * A multiplicação empacota blocos dos operandos em painéis contíguos, dimensionados para as
+ * caches, e os percorre com um micronúcleo que mantém um bloco do resultado em registradores.
+ * O micronúcleo é escolhido em tempo de execução entre as versões AVX-512, AVX2 e escalar,
+ * de acordo com o processador.
+ *
+ ********************************************************************************************/
+
+#ifndef GEMM_H
+#define GEMM_H
+
+#include "Numeric.h"
+
+namespace NM {
+
+   /*************************************************************************
+    * Fornece uma identificação para o micronúcleo da multiplicação.
+    *************************************************************************/
+	enum gemmKernel {
+		AUTOMATIC_KERNEL, /**< Melhor micronúcleo suportado pelo processador.*/
+		SCALAR_KERNEL, /**< Micronúcleo portátil, sem instruções vetoriais explícitas.*/
+		AVX2_KERNEL, /**< Micronúcleo 4x8 (4x16 em precisão simples) com AVX2 e FMA.*/
+		AVX512_KERNEL /**< Micronúcleo 8x8 (8x16 em precisão simples) com AVX-512.*/
+	};
+
+
+   /*************************************************************************
+    * Multiplica duas visões e acumula o resultado.
+    *
+    * Calcula c += alpha*a*b pelo algoritmo blocado. As visões podem ter
+    * distâncias quaisquer (transpostas são lidas diretamente durante o
+    * empacotamento), mas c não pode se sobrepor a a ou b.
+    *
+    * @param a Visão à esquerda (m x k).
+    * @param b Visão à direita (k x n).
+    * @param c Visão do destino (m x n).
+    * @param alpha Escala do produto.
+	*
+    * @return Void.
+    *************************************************************************/
+	void gemm(const ConstMatrixView &a, const ConstMatrixView &b, const MatrixView &c, double alpha);
+
+
+   /*************************************************************************
+    * Multiplica duas visões em precisão simples e acumula o resultado.
+    *
+    * Versão de gemm para float, usada pela fatoração em precisão simples.
+    * Os micronúcleos vetoriais processam o dobro de elementos por instrução.
+    *
+    * @param a Visão à esquerda (m x k).
+    * @param b Visão à direita (k x n).
+    * @param c Visão do destino (m x n).
+    * @param alpha Escala do produto.
+	*
+    * @return Void.
+	*
+	* @overload
+    *************************************************************************/
+	void gemm(const ConstFloatMatrixView &a, const ConstFloatMatrixView &b, const FloatMatrixView &c, float alpha);
+
+
+   /*************************************************************************
+    * Escolhe o micronúcleo da multiplicação.
+    *
+    * Destinado a testes e medições; deve ser chamado antes de qualquer
+    * multiplicação concorrente.
+    *
+    * @param k Micronúcleo desejado. AUTOMATIC_KERNEL volta à detecção.
+	*
+    * @return Void.
+    *************************************************************************/
+	void setGemmKernel(gemmKernel k);
+
+
+   /*************************************************************************
+    * Getter para o micronúcleo em uso.
+    *
+    * @return Micronúcleo efetivamente usado pela multiplicação.
+    *************************************************************************/
+	gemmKernel getGemmKernel();
+
+
+   /*************************************************************************
+    * Verifica se o processador suporta um micronúcleo.
+    *
+    * @param k Micronúcleo consultado.
+	*
+    * @return true se o micronúcleo pode ser usado.
+    *************************************************************************/
+	bool isGemmKernelSupported(gemmKernel k);
+}
+
+#endif
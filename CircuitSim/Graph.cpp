@@ -16,45 +16,78 @@
  ********************************************************************************************/
 
 #include "Graph.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
 #include <vector>
 #include <stack>
 
 namespace GRF{
 
+	const unsigned int incidenceMatrix::noVertex;
+	const unsigned int spanningForest::none;
+
     //Construtor da matriz se chamado sem parâmetro cria a matriz vazia
 	incidenceMatrix::incidenceMatrix() {
 		vertexNumber = 0;
 		edgeNumber = 0;
 	}
-	//Construtor da matriz, cria a matriz com 'v' vertices e 'e' edges
-	incidenceMatrix::incidenceMatrix(unsigned int v,  unsigned int e) {
-		for(unsigned int i = 0; i < v; i++)
-			inMatrix.push_back(std::vector<int>(e, 0));
-
+	//Construtor da matriz, cria a matriz com 'v' vertices e 'e' edges, todas sem conexão
+	incidenceMatrix::incidenceMatrix(unsigned int v,  unsigned int e)
+		: edgeTail(e, noVertex), edgeHead(e, noVertex), incidence(v) {
 		vertexNumber = v;
 		edgeNumber = e;
 	}
+
+	int incidenceMatrix::getIncidence(unsigned int vtx, unsigned int edg) const {
+		if(edgeTail[edg] == vtx)
+			return 1;
+		if(edgeHead[edg] == vtx)
+			return -1;
+		return 0;
+	}
+
+    //Remove a aresta da lista do vértice, mantendo a ordem crescente.
+	void incidenceMatrix::unlink(unsigned int vtx, unsigned int edg) {
+		std::vector<unsigned int> &list = incidence[vtx];
+		std::vector<unsigned int>::iterator it = std::lower_bound(list.begin(), list.end(), edg);
+		if(it != list.end() and *it == edg)
+			list.erase(it);
+	}
 	
 	//Cria uma conexao entre vertices em um grafo que ja possui tamanho definido
 	void incidenceMatrix::makeCon(unsigned int vtx1,  unsigned int vtx2,  unsigned int edg) {
 		if(vtx1 >= vertexNumber or vtx2 >= vertexNumber or edg >= edgeNumber)
             throw std::string("Acesso invalido");
 
-		inMatrix[vtx1][edg] = 1;
-		inMatrix[vtx2][edg] = -1;
+        //Conexões anteriores da aresta são substituídas.
+		if(edgeTail[edg] != noVertex)
+			unlink(edgeTail[edg], edg);
+		if(edgeHead[edg] != noVertex)
+			unlink(edgeHead[edg], edg);
+
+		edgeTail[edg] = vtx1;
+		edgeHead[edg] = vtx2;
+		for(unsigned int vtx : {vtx1, vtx2}) {
+			std::vector<unsigned int> &list = incidence[vtx];
+			std::vector<unsigned int>::iterator it = std::lower_bound(list.begin(), list.end(), edg);
+			if(it == list.end() or *it != edg)
+				list.insert(it, edg);
+		}
 	}
 	//Adiciona uma nova aresta no grafo
 	void incidenceMatrix::addEdge(unsigned int vtx1,  unsigned int vtx2) {
 		while(vertexNumber <= vtx1 or vertexNumber <= vtx2) {
-            inMatrix.push_back(std::vector<int>(edgeNumber, 0));
+			incidence.emplace_back();
 			vertexNumber++;
 		}
 
-		for(unsigned int k = 0; k < vertexNumber; k++)
-			inMatrix[k].push_back(0);
-
-		inMatrix[vtx1][edgeNumber] = 1;
-		inMatrix[vtx2][edgeNumber] = -1;
+        //A nova aresta tem o maior índice, e vai para o fim das listas.
+		edgeTail.push_back(vtx1);
+		edgeHead.push_back(vtx2);
+		incidence[vtx1].push_back(edgeNumber);
+		if(vtx2 != vtx1)
+			incidence[vtx2].push_back(edgeNumber);
 		edgeNumber++;
 	}
 
@@ -64,16 +97,19 @@ namespace GRF{
 		if(edg >= getEdgeNumber())
             throw std::string("Acesso invalido");
 
-		for(unsigned int i = 0; i < getEdgeNumber();i++){
-			if(i > edg){
-				for(unsigned int j = 0; j < getVertexNumber(); j++){
-					inMatrix[j][i-1] = inMatrix[j][i];
-				}
-			}
-		}
-		for(unsigned int i = 0; i < getVertexNumber(); i++){
-			inMatrix[i].pop_back();
-		}
+		if(edgeTail[edg] != noVertex)
+			unlink(edgeTail[edg], edg);
+		if(edgeHead[edg] != noVertex)
+			unlink(edgeHead[edg], edg);
+
+		edgeTail.erase(edgeTail.begin() + edg);
+		edgeHead.erase(edgeHead.begin() + edg);
+
+        //As arestas seguintes são renumeradas.
+		for(std::vector<unsigned int> &list : incidence)
+			for(unsigned int &e : list)
+				if(e > edg)
+					e--;
 		edgeNumber--;
 	}
 
@@ -82,14 +118,22 @@ namespace GRF{
 		if(vtx >= getVertexNumber())
             throw std::string("Acesso invalido");
 
-		for(unsigned int i = 0; i < getVertexNumber(); i++){
-			if(i>vtx){
-				for(unsigned int j = 0; j < getEdgeNumber(); j++){
-					inMatrix[i-1][j] = inMatrix[i][j];
-				}
-			}
+        //As arestas do vértice perdem este extremo.
+		for(unsigned int e : incidence[vtx]){
+			if(edgeTail[e] == vtx)
+				edgeTail[e] = noVertex;
+			if(edgeHead[e] == vtx)
+				edgeHead[e] = noVertex;
+		}
+		incidence.erase(incidence.begin() + vtx);
+
+        //Os vértices seguintes são renumerados.
+		for(unsigned int e = 0; e < edgeNumber; e++){
+			if(edgeTail[e] != noVertex and edgeTail[e] > vtx)
+				edgeTail[e]--;
+			if(edgeHead[e] != noVertex and edgeHead[e] > vtx)
+				edgeHead[e]--;
 		}
-		inMatrix.pop_back();
 		vertexNumber--;
 	}
 
@@ -110,6 +154,7 @@ namespace GRF{
             throw std::string("Acesso invalido");
 
 		std::vector<int> vEdg(edgeNumber,0);
+		std::vector<unsigned int> next(vertexNumber,0);
 		std::stack<unsigned int> aux;
 
 		unsigned int vtx = 0;
@@ -117,15 +162,19 @@ namespace GRF{
 		
 		aux.push(key);
 
+        //Cada vértice percorre apenas a sua lista de arestas. Uma aresta descartada nunca volta
+        //a ser candidata, então a busca continua de onde parou (next): O(V + E) no total.
 		while(not aux.empty() and not found){
 
 			vtx= aux.top();
+			const std::vector<unsigned int> &list = incidence[vtx];
 			
-			for(unsigned int i= 0; i<getEdgeNumber(); i++){
-				if(inMatrix[vtx][i] and not vEdg[i]){
+			for(; next[vtx]<list.size(); next[vtx]++){
+				unsigned int i = list[next[vtx]];
+				if(not vEdg[i]){
 					unsigned int j = getVertexCon(vtx,i);
 					aux.push(j);
-					vEdg[i]= inMatrix[vtx][i];
+					vEdg[i]= getIncidence(vtx,i);
 					if (j ==key)
 						found = true;
 					break;
@@ -133,10 +182,8 @@ namespace GRF{
 			}
 				
 			if(vtx==aux.top() and not found){
-				std::vector<unsigned int>temp = getEdges(vtx);
-				
-				for(unsigned int i = 0; i<temp.size();i++)
-					vEdg[temp[i]] = 2;
+				for(unsigned int i = 0; i<list.size();i++)
+					vEdg[list[i]] = 2;
 
 				aux.pop();
 			}	
@@ -158,22 +205,26 @@ namespace GRF{
 			throw "Acesso invalido";
 
 		std::vector<bool> visited(vertexNumber,false);
+		std::vector<unsigned int> next(vertexNumber,0);
 		std::stack<unsigned int> aux;
 		incidenceMatrix tree(vertexNumber,edgeNumber);
 		unsigned int vtx = 0;
 		
 		aux.push(key);
 
+        //Como em getLoop, cada vértice retoma a sua lista de onde parou.
 		while(not aux.empty()){
 
 			vtx= aux.top();
 			visited[vtx]=true;
+			const std::vector<unsigned int> &list = incidence[vtx];
 
-			for(unsigned int i= 0; i<edgeNumber; i++){
+			for(; next[vtx]<list.size(); next[vtx]++){
 
+				unsigned int i = list[next[vtx]];
 				unsigned int j = getVertexCon(vtx,i);
 
-				if(inMatrix[vtx][i] and not visited[j]){
+				if(not visited[j]){
 					aux.push(j);
 					try{
 						tree.makeCon(vtx,j,i);
@@ -189,18 +240,389 @@ namespace GRF{
 		return tree;
 	}
 
+	spanningForest incidenceMatrix::emptyForest() const{
+		spanningForest forest;
+		forest.parent.assign(vertexNumber, spanningForest::none);
+		forest.parentEdge.assign(vertexNumber, spanningForest::none);
+		forest.depth.assign(vertexNumber, 0);
+		forest.order.reserve(vertexNumber);
+		return forest;
+	}
+
+    //Busca em largura em que a fila é o próprio vetor order.
+	void incidenceMatrix::growTree(spanningForest &forest, unsigned int root, std::vector<bool> &inTree,
+	                               const std::vector<bool> &allowed) const{
+		forest.parent[root] = root;
+		forest.roots.push_back(root);
+		forest.order.push_back(root);
+
+		for(std::size_t head = forest.order.size() - 1; head < forest.order.size(); head++){
+			const unsigned int vtx = forest.order[head];
+			for(unsigned int e : incidence[vtx]){
+				const unsigned int j = (edgeTail[e] == vtx) ? edgeHead[e] : edgeTail[e];
+				if(j == noVertex or forest.parent[j] != spanningForest::none or (not allowed.empty() and not allowed[e]))
+					continue;
+
+				forest.parent[j] = vtx;
+				forest.parentEdge[j] = e;
+				forest.depth[j] = forest.depth[vtx] + 1;
+				forest.order.push_back(j);
+				inTree[e] = true;
+			}
+		}
+	}
+
+	void incidenceMatrix::finishForest(spanningForest &forest, std::vector<bool> &inTree, const std::vector<bool> &allowed) const{
+		for(unsigned int v = 0; v < vertexNumber; v++)
+			if(forest.parent[v] == spanningForest::none)
+				growTree(forest, v, inTree, allowed);
+
+		for(unsigned int e = 0; e < edgeNumber; e++)
+			if(not inTree[e] and edgeTail[e] != noVertex and edgeHead[e] != noVertex)
+				forest.chords.push_back(e);
+	}
+
+    //Busca em largura a partir de key e, em seguida, de cada vértice ainda não alcançado.
+	spanningForest incidenceMatrix::getSpanningForest(unsigned int key) const{
+
+		if(vertexNumber and key>=vertexNumber)
+            throw std::string("Acesso invalido");
+
+		spanningForest forest = emptyForest();
+		std::vector<bool> inTree(edgeNumber, false);
+		if(vertexNumber)
+			growTree(forest, key, inTree, std::vector<bool>());
+		finishForest(forest, inTree, std::vector<bool>());
+		return forest;
+	}
+
+    //Em cada componente, os vértices periféricos são encontrados por buscas em largura
+    //sucessivas, a partir do último vértice da árvore de getSpanningForest. maxDistance guarda,
+    //para cada vértice, a maior distância aos periféricos já percorridos; o vértice em que ela é
+    //mínima é o candidato a centro, e a busca a partir dele mede a sua excentricidade e dá o
+    //próximo periférico. A raiz original é o primeiro candidato, e só é trocada por um vértice
+    //de excentricidade menor.
+	spanningForest incidenceMatrix::getCentralSpanningForest() const{
+		const unsigned int centerRounds = 3;
+		const unsigned int none = spanningForest::none;
+		const spanningForest first = getSpanningForest(0);
+
+		std::vector<unsigned int> distance(vertexNumber, none), maxDistance(vertexNumber, 0), queue;
+		queue.reserve(vertexNumber);
+
+        //Busca em largura a partir de source; retorna a excentricidade, e o último vértice da
+        //fila é o mais distante.
+		const auto sweep = [&](unsigned int source){
+			queue.assign(1, source);
+			distance[source] = 0;
+			for(std::size_t head = 0; head < queue.size(); head++){
+				const unsigned int vtx = queue[head];
+				for(unsigned int e : incidence[vtx]){
+					const unsigned int j = (edgeTail[e] == vtx) ? edgeHead[e] : edgeTail[e];
+					if(j == noVertex or distance[j] != none)
+						continue;
+					distance[j] = distance[vtx] + 1;
+					queue.push_back(j);
+				}
+			}
+			return distance[queue.back()];
+		};
+		const auto clear = [&](){
+			for(unsigned int v : queue)
+				distance[v] = none;
+		};
+		const auto addPeripheral = [&](unsigned int v){
+			sweep(v);
+			for(unsigned int u : queue)
+				maxDistance[u] = std::max(maxDistance[u], distance[u]);
+			const unsigned int far = queue.back();
+			clear();
+			return far;
+		};
+
+		std::vector<unsigned int> centers;
+		for(std::size_t begin = 0, end; begin < first.order.size(); begin = end){
+            //As árvores estão em sequência em order, cada uma a partir da sua raiz.
+			for(end = begin + 1; end < first.order.size() and first.parent[first.order[end]] != first.order[end]; end++);
+
+			unsigned int best = first.order[begin];
+			unsigned int bestHeight = first.depth[first.order[end - 1]];
+			addPeripheral(addPeripheral(first.order[end - 1]));
+
+			for(unsigned int round = 0; round < centerRounds and bestHeight > 1; round++){
+				unsigned int candidate = best;
+				for(std::size_t k = begin; k < end; k++)
+					if(maxDistance[first.order[k]] < maxDistance[candidate])
+						candidate = first.order[k];
+
+				const unsigned int height = sweep(candidate);
+				const unsigned int far = queue.back();
+				clear();
+				if(height < bestHeight){
+					best = candidate;
+					bestHeight = height;
+				}
+				addPeripheral(far);
+			}
+			centers.push_back(best);
+		}
+
+		spanningForest forest = emptyForest();
+		std::vector<bool> inTree(edgeNumber, false);
+		for(unsigned int c : centers)
+			growTree(forest, c, inTree, std::vector<bool>());
+		finishForest(forest, inTree, std::vector<bool>());
+		return forest;
+	}
+
+    //A cada nível, o grafo dos grupos é montado em forma compacta (start/adjacent), e bolas de
+    //raio ballRadius crescem a partir de cada grupo ainda livre. Um grupo que não absorveu nenhum
+    //vizinho é ligado a um grupo adjacente, de modo que o número de grupos cai pelo menos à
+    //metade a cada nível.
+	spanningForest incidenceMatrix::getLowStretchSpanningForest() const{
+		const unsigned int ballRadius = 2;
+		const unsigned int none = spanningForest::none;
+
+		std::vector<unsigned int> cluster(vertexNumber);
+		for(unsigned int v = 0; v < vertexNumber; v++)
+			cluster[v] = v;
+		unsigned int clusters = vertexNumber;
+		std::vector<bool> inTree(edgeNumber, false);
+
+		std::vector<unsigned int> start, adjacent, label, size, frontier, next;
+		while(true){
+			start.assign(clusters + 1, 0);
+			for(unsigned int e = 0; e < edgeNumber; e++){
+				if(edgeTail[e] == noVertex or edgeHead[e] == noVertex or cluster[edgeTail[e]] == cluster[edgeHead[e]])
+					continue;
+				start[cluster[edgeTail[e]] + 1]++;
+				start[cluster[edgeHead[e]] + 1]++;
+			}
+			for(unsigned int c = 0; c < clusters; c++)
+				start[c + 1] += start[c];
+			if(start[clusters] == 0)
+				break;
+
+			adjacent.resize(start[clusters]);
+			next.assign(start.begin(), start.end() - 1);
+			for(unsigned int e = 0; e < edgeNumber; e++){
+				if(edgeTail[e] == noVertex or edgeHead[e] == noVertex or cluster[edgeTail[e]] == cluster[edgeHead[e]])
+					continue;
+				adjacent[next[cluster[edgeTail[e]]]++] = e;
+				adjacent[next[cluster[edgeHead[e]]]++] = e;
+			}
+
+			label.assign(clusters, none);
+			size.clear();
+			for(unsigned int c = 0; c < clusters; c++){
+				if(label[c] != none)
+					continue;
+
+				const unsigned int group = size.size();
+				label[c] = group;
+				size.push_back(1);
+				frontier.assign(1, c);
+				for(unsigned int layer = 0; layer < ballRadius and not frontier.empty(); layer++){
+					next.clear();
+					for(unsigned int a : frontier){
+						for(unsigned int k = start[a]; k < start[a + 1]; k++){
+							const unsigned int e = adjacent[k];
+							const unsigned int b = (cluster[edgeTail[e]] == a) ? cluster[edgeHead[e]] : cluster[edgeTail[e]];
+							if(label[b] != none)
+								continue;
+							label[b] = group;
+							size[group]++;
+							inTree[e] = true;
+							next.push_back(b);
+						}
+					}
+					frontier.swap(next);
+				}
+
+                //Todos os vizinhos já pertencem a outros grupos: junta-se ao primeiro deles.
+				if(size[group] == 1 and start[c] < start[c + 1]){
+					const unsigned int e = adjacent[start[c]];
+					const unsigned int b = (cluster[edgeTail[e]] == c) ? cluster[edgeHead[e]] : cluster[edgeTail[e]];
+					size.pop_back();
+					label[c] = label[b];
+					size[label[b]]++;
+					inTree[e] = true;
+				}
+			}
+
+			for(unsigned int v = 0; v < vertexNumber; v++)
+				cluster[v] = label[cluster[v]];
+			clusters = size.size();
+		}
+
+        //A floresta é orientada por buscas em largura restritas às arestas escolhidas.
+		spanningForest forest = emptyForest();
+		std::vector<bool> used(edgeNumber, false);
+		finishForest(forest, used, inTree);
+		return forest;
+	}
+
+    //Índice do bit menos significativo de uma palavra não nula.
+	static unsigned int lowestBit(std::uint64_t w){
+#if defined(__GNUC__)
+		return __builtin_ctzll(w);
+#else
+		unsigned int b = 0;
+		while(not (w & 1)){
+			w >>= 1;
+			b++;
+		}
+		return b;
+#endif
+	}
+
+	std::vector<std::vector<std::pair<unsigned int, int>>> incidenceMatrix::getShortCycleBasis(const spanningForest &reference,
+	                                                                                           unsigned int radius) const{
+		const unsigned int none = spanningForest::none;
+		const std::size_t n = reference.chords.size();
+		std::vector<std::vector<std::pair<unsigned int, int>>> candidates;
+
+        //Candidatos: para cada raiz r, os ciclos formados por uma aresta fora da árvore de busca
+        //(de profundidade radius) e pelos caminhos dos seus extremos até r. Para não repetir um
+        //mesmo ciclo a partir de cada um dos seus vértices, r deve ser o menor vértice do ciclo.
+		spanningForest local = emptyForest();
+		for(unsigned int r = 0; r < vertexNumber; r++){
+			local.parent[r] = r;
+			local.order.assign(1, r);
+			for(std::size_t head = 0; head < local.order.size(); head++){
+				const unsigned int vtx = local.order[head];
+				if(local.depth[vtx] == radius)
+					continue;
+				for(unsigned int e : incidence[vtx]){
+					const unsigned int j = (edgeTail[e] == vtx) ? edgeHead[e] : edgeTail[e];
+					if(j == noVertex or j < r or local.parent[j] != none)
+						continue;
+					local.parent[j] = vtx;
+					local.parentEdge[j] = e;
+					local.depth[j] = local.depth[vtx] + 1;
+					local.order.push_back(j);
+				}
+			}
+
+			for(unsigned int vtx : local.order){
+				for(unsigned int e : incidence[vtx]){
+					const unsigned int j = (edgeTail[e] == vtx) ? edgeHead[e] : edgeTail[e];
+					if(edgeTail[e] != vtx or j == noVertex or local.parent[j] == none or
+					   e == local.parentEdge[vtx] or e == local.parentEdge[j])
+						continue;
+
+                    //O ciclo só passa por r se o menor ancestral comum dos extremos é r.
+					unsigned int u = vtx, v = j;
+					while(u != v){
+						if(local.depth[u] >= local.depth[v])
+							u = local.parent[u];
+						else
+							v = local.parent[v];
+					}
+					if(u != r)
+						continue;
+
+					candidates.emplace_back();
+					getFundamentalLoop(local, e, candidates.back());
+				}
+			}
+
+			for(unsigned int vtx : local.order){
+				local.parent[vtx] = none;
+				local.parentEdge[vtx] = none;
+				local.depth[vtx] = 0;
+			}
+		}
+
+		for(unsigned int chord : reference.chords){
+			candidates.emplace_back();
+			getFundamentalLoop(reference, chord, candidates.back());
+		}
+
+		std::vector<unsigned int> sorted(candidates.size());
+		for(unsigned int k = 0; k < sorted.size(); k++)
+			sorted[k] = k;
+		std::stable_sort(sorted.begin(), sorted.end(), [&](unsigned int a, unsigned int b){
+			return candidates[a].size() < candidates[b].size();
+		});
+
+        //Eliminação sobre GF(2). Um ciclo é determinado pelas cordas de reference que contém;
+        //cada linha aceita é guardada reduzida, com pivô no seu bit menos significativo.
+		std::vector<unsigned int> chordIndex(edgeNumber, none);
+		for(unsigned int k = 0; k < n; k++)
+			chordIndex[reference.chords[k]] = k;
+
+		const std::size_t words = (n + 63) / 64;
+		std::vector<std::uint64_t> rows, vec(words);
+		std::vector<unsigned int> pivotRow(n, none);
+		std::vector<std::vector<std::pair<unsigned int, int>>> basis;
+		basis.reserve(n);
+
+		for(unsigned int k = 0; k < sorted.size() and basis.size() < n; k++){
+			std::fill(vec.begin(), vec.end(), 0);
+			for(const std::pair<unsigned int, int> &e : candidates[sorted[k]])
+				if(chordIndex[e.first] != none)
+					vec[chordIndex[e.first] / 64] ^= std::uint64_t(1) << (chordIndex[e.first] % 64);
+
+			for(std::size_t w = 0; w < words; w++){
+				while(vec[w]){
+					const unsigned int bit = w * 64 + lowestBit(vec[w]);
+					if(pivotRow[bit] == none){
+						pivotRow[bit] = basis.size();
+						rows.insert(rows.end(), vec.begin(), vec.end());
+						basis.push_back(std::move(candidates[sorted[k]]));
+						w = words;
+						break;
+					}
+					const std::uint64_t *row = &rows[pivotRow[bit] * words];
+					for(std::size_t i = w; i < words; i++)
+						vec[i] ^= row[i];
+				}
+			}
+		}
+		return basis;
+	}
+
+    //Percorrendo a corda de u para v, o ciclo volta de v para u pela árvore: sobe de v até o
+    //ancestral comum (arestas no sentido filho -> pai) e desce até u (sentido pai -> filho).
+	void incidenceMatrix::getFundamentalLoop(const spanningForest &forest, unsigned int chord,
+	                                         std::vector<std::pair<unsigned int, int>> &loop) const{
+
+		if(chord>=edgeNumber or edgeTail[chord] == noVertex or edgeHead[chord] == noVertex)
+            throw std::string("Acesso invalido");
+
+		unsigned int u = edgeTail[chord], v = edgeHead[chord];
+		loop.clear();
+		loop.push_back({chord, 1});
+
+		while(u != v){
+			if(forest.depth[v] >= forest.depth[u]){
+				const unsigned int e = forest.parentEdge[v];
+				if(e == spanningForest::none)
+                    throw std::string("Corda entre arvores diferentes");
+				loop.push_back({e, edgeTail[e] == v ? 1 : -1});
+				v = forest.parent[v];
+			}
+			else{
+				const unsigned int e = forest.parentEdge[u];
+				loop.push_back({e, edgeTail[e] == u ? -1 : 1});
+				u = forest.parent[u];
+			}
+		}
+
+		std::sort(loop.begin(), loop.end());
+	}
+
 	//Retorna o vertice que esta ligado a vtx pela aresta edg
 	unsigned int incidenceMatrix::getVertexCon(unsigned int vtx,  unsigned int edg) {
 
 		if(vtx>=vertexNumber or edg>=edgeNumber)
             throw std::string("Acesso invalido");
 
-		if(inMatrix[vtx][edg]){
-			for(unsigned int i = 0;i<vertexNumber;i++){
-				if(i!= vtx and inMatrix[i][edg])
-					return i;
-			}
-		}
+		if(edgeTail[edg] == vtx and edgeHead[edg] != noVertex)
+			return edgeHead[edg];
+		if(edgeHead[edg] == vtx and edgeTail[edg] != noVertex)
+			return edgeTail[edg];
 		return vtx; 
 	}
 
@@ -210,13 +632,7 @@ namespace GRF{
             throw std::string("Acesso invalido");
 		}
 		
-		std::vector<unsigned int>temp;
-		
-		for(unsigned int i = 0; i<getEdgeNumber();i++){
-			if(inMatrix[vtx][i])
-				temp.push_back(i); 
-		}
-		return temp;
+		return incidence[vtx];
 	}
 
 	std::vector<unsigned int> incidenceMatrix::getEdges(unsigned int vtx1,  unsigned int vtx2){
@@ -224,12 +640,10 @@ namespace GRF{
 		if(vtx1>=getVertexNumber() or vtx2>=getVertexNumber())
             throw std::string("Acesso invalido");
 
+        //Interseção das listas ordenadas dos dois vértices.
 		std::vector<unsigned int> temp;
-		
-		for(unsigned int i = 0; i<edgeNumber;i++){
-			if(inMatrix[vtx1][i] and inMatrix[vtx2][i])
-				temp.push_back(i);
-		}
+		std::set_intersection(incidence[vtx1].begin(), incidence[vtx1].end(), incidence[vtx2].begin(), incidence[vtx2].end(),
+		                      std::back_inserter(temp));
 		return temp;
 	}
 
@@ -238,29 +652,15 @@ namespace GRF{
 		if(edg>=edgeNumber)
             throw std::string("Acesso invalido");
 		
-		std::pair<unsigned int,unsigned int> vtx(0,0);
-
-		for(unsigned int i= 0; i<vertexNumber; i++){
-			if(inMatrix[i][edg]){
-				if(inMatrix[i][edg]==1)
-					vtx.first=i;
-				else
-					vtx.second=i;
-			}
-		}
-		return vtx;
+		return std::pair<unsigned int,unsigned int>(edgeTail[edg] == noVertex ? 0 : edgeTail[edg],
+		                                            edgeHead[edg] == noVertex ? 0 : edgeHead[edg]);
 	}
 
 	unsigned int incidenceMatrix::getConNum(unsigned int vtx){
 		if(vtx>=getVertexNumber())
             return 0;//throw "Acesso invalido";
-		unsigned int num = 0;
 
-		for(unsigned int i = 0; i<getEdgeNumber();i++){
-			if(inMatrix[vtx][i])
-				num++;
-		}
-		return num;
+		return incidence[vtx].size();
 	}
 
     adjacencyMatrix::adjacencyMatrix() {
@@ -8,7 +8,7 @@
  * de grafo distintas. 
  * 
  * A classe incidenceMatrix implementa um grafo que utiliza matriz 
- * de incidência como estrutura base.
+ * de incidência como estrutura base, armazenada de forma esparsa.
  * 
  * A classe adjacencyMatrix implemeta um grafo 
  * utilizando matriz de adjacência como estrutura base.
@@ -23,6 +23,25 @@
 
 namespace GRF{
 
+   /****************************************************************************
+    * Declaração da estrutura spanningForest.
+    *
+    * Floresta geradora de um grafo, com uma árvore por componente conexa,
+    * representada pelo pai de cada vértice. As arestas são consideradas sem
+    * direção na construção da floresta.
+    ***************************************************************************/
+	struct spanningForest{
+		static const unsigned int none = ~0u; /**< Aresta-pai das raízes.*/
+
+		std::vector<unsigned int> parent; /**< Pai de cada vértice (o próprio vértice nas raízes).*/
+		std::vector<unsigned int> parentEdge; /**< Aresta que liga cada vértice ao pai (none nas raízes).*/
+		std::vector<unsigned int> depth; /**< Distância de cada vértice à raiz da sua árvore, em arestas.*/
+		std::vector<unsigned int> order; /**< Vértices na ordem de visita: cada pai antes dos seus filhos.*/
+		std::vector<unsigned int> roots; /**< Raiz de cada árvore (uma por componente conexa).*/
+		std::vector<unsigned int> chords; /**< Arestas fora da floresta, em ordem crescente (cada uma fecha um ciclo fundamental).*/
+	};
+
+
    /****************************************************************************
     * Declaração da classe incidenceMatrix.
     *
@@ -34,6 +53,11 @@ namespace GRF{
     *
     * Esta classe é feita especificamente para grafos que não possuem
     * uma aresta com mesmo vértice nos pontos final e inicial (self-loop).
+    *
+    * A matriz de incidência tem no máximo duas entradas não nulas por
+    * coluna, e é armazenada de forma esparsa: os extremos de cada aresta
+    * (colunas) e a lista das arestas de cada vértice (linhas), em ordem
+    * crescente. A memória é O(V + E).
     ***************************************************************************/
 	class incidenceMatrix{
 
@@ -41,8 +65,72 @@ namespace GRF{
             unsigned int vertexNumber; /**< Armazena o número de vértices do grafo.*/
             unsigned int edgeNumber; /**< Armazena o número de arestas do grafo.*/
 
+           /***********************************************************************************************
+            * Remove uma aresta da lista de um vértice.
+            *
+            * @param vtx Vértice.
+            * @param edge Aresta a ser removida da lista.
+            *
+            * @return Void.
+            ***********************************************************************************************/
+            void unlink(unsigned int vtx, unsigned int edge);
+
+
+           /***********************************************************************************************
+            * Cria uma floresta sem vértices alcançados.
+            *
+            * @return Floresta com os vetores dimensionados para o grafo.
+            ***********************************************************************************************/
+            spanningForest emptyForest() const;
+
+
+           /***********************************************************************************************
+            * Acrescenta uma árvore a uma floresta em construção.
+            *
+            * Busca em largura a partir de root, que ainda não pode ter sido alcançado, pelos
+            * vértices ainda não alcançados.
+            *
+            * @param forest Floresta em construção.
+            * @param root Raiz da nova árvore.
+            * @param inTree Marca as arestas da floresta.
+            * @param allowed Arestas que podem ser usadas (todas, se vazio).
+            *
+            * @return Void.
+            ***********************************************************************************************/
+            void growTree(spanningForest &forest, unsigned int root, std::vector<bool> &inTree,
+                          const std::vector<bool> &allowed) const;
+
+
+           /***********************************************************************************************
+            * Completa uma floresta em construção.
+            *
+            * Cria uma árvore para cada vértice ainda não alcançado, em ordem crescente, e preenche as
+            * cordas.
+            *
+            * @param forest Floresta em construção.
+            * @param inTree Marca as arestas da floresta.
+            * @param allowed Arestas que podem ser usadas (todas, se vazio).
+            *
+            * @return Void.
+            ***********************************************************************************************/
+            void finishForest(spanningForest &forest, std::vector<bool> &inTree, const std::vector<bool> &allowed) const;
+
 		protected:
-            std::vector<std::vector<int>> inMatrix; /**< Vector bidimensional que armazena as conexões entre os vértices*/
+            static const unsigned int noVertex = ~0u; /**< Extremo de uma aresta sem conexão.*/
+
+            std::vector<unsigned int> edgeTail; /**< Vértice de saída de cada aresta (entrada 1 da coluna), ou noVertex.*/
+            std::vector<unsigned int> edgeHead; /**< Vértice de entrada de cada aresta (entrada -1 da coluna), ou noVertex.*/
+            std::vector<std::vector<unsigned int>> incidence; /**< Arestas conectadas a cada vértice, em ordem crescente.*/
+
+           /***********************************************************************************************
+            * Entrada da matriz de incidência.
+            *
+            * @param vtx Vértice (linha).
+            * @param edge Aresta (coluna).
+            *
+            * @return 1 se vtx é o vértice de saída de edge, -1 se é o de entrada e 0 caso contrário.
+            ***********************************************************************************************/
+            int getIncidence(unsigned int vtx, unsigned int edge) const;
 
 		public:
 
@@ -71,8 +159,8 @@ namespace GRF{
             * Adiciona uma conexção entre dois vértices.
             *
             * Cria uma conexão entre dois vértices do grafo. A conexão é direcionada de vtx1 para vtx2.
-            * Uma nova coluna é alocada dinâmicamente. Se ao menos um dos vértices não existe, estes são
-            * criados até que a matriz tenha tamanho suficiente para armazená-lo.
+            * Uma nova coluna é criada em O(1) amortizado. Se ao menos um dos vértices não existe, estes
+            * são criados até que a matriz tenha tamanho suficiente para armazená-lo.
             *
             * @param vtx1 Vértice de saída.
             * @param vtx2 Vértice de entrada.
@@ -102,7 +190,8 @@ namespace GRF{
             * Remove uma conexão de um objeto da classe incidenceMatrix.
             *
             * Remove a aresta especificada existente entre dois vértices de um objeto, reduzindo o
-            * tamanho da matriz através da remoção de uma coluna.
+            * tamanho da matriz através da remoção de uma coluna. As arestas seguintes são renumeradas
+            * nas listas dos vértices, em O(V + E).
             *
             * @param edge Aresta a ser removida do grafo.
             *
@@ -116,6 +205,7 @@ namespace GRF{
             *
             * Remove o vértice especificado existente de um objeto, reduzindo o tamanho da matriz através
             * da remoção de uma linha. Todas as conexões entre este e outros vértices também é excluído.
+            * Os extremos das arestas são renumerados em O(E).
             *
             * @param vtx Vértice a ser removido do grafo.
             *
@@ -172,10 +262,92 @@ namespace GRF{
 			incidenceMatrix getSpanningTree( unsigned int key);
 
 
+           /***********************************************************************************************
+            * Getter para a floresta geradora de um objeto da classe incidenceMatrix.
+            *
+            * Constrói, por busca em largura, uma árvore geradora para cada componente conexa do
+            * grafo, em O(V + E). A primeira árvore tem raiz em key; as demais, no menor vértice da
+            * componente. Arestas com um só extremo não pertencem à floresta nem às cordas.
+            *
+            * @param key Raiz da primeira árvore.
+            *
+            * @return Floresta geradora, com os pais, as profundidades e as cordas.
+            ***********************************************************************************************/
+			spanningForest getSpanningForest(unsigned int key) const;
+
+
+           /***********************************************************************************************
+            * Getter para a floresta geradora de profundidade mínima de um objeto da classe incidenceMatrix.
+            *
+            * Como getSpanningForest, mas cada árvore tem raiz em um vértice central da sua componente:
+            * o de menor distância máxima a vértices periféricos encontrados por algumas buscas em
+            * largura sucessivas. Em malhas como as grades, a altura das árvores cai aproximadamente à
+            * metade, e com ela o comprimento dos ciclos fundamentais; nenhuma árvore é mais alta que
+            * a de getSpanningForest(0). Executa em O(V + E).
+            *
+            * @return Floresta geradora.
+            ***********************************************************************************************/
+			spanningForest getCentralSpanningForest() const;
+
+
+           /***********************************************************************************************
+            * Getter para uma floresta geradora de baixo estiramento de um objeto da classe incidenceMatrix.
+            *
+            * Agrupamento hierárquico no estilo de Alon, Karp, Peleg e West: a cada nível, bolas de raio
+            * pequeno crescem por busca em largura sobre o grafo dos grupos do nível anterior, e cada
+            * bola vira um grupo. As arestas que unem os grupos formam a floresta. Arestas entre vértices
+            * próximos tendem a ficar no mesmo grupo, ligados por caminhos curtos, o que reduz o
+            * estiramento médio (comprimento do caminho na árvore entre os extremos de cada corda).
+            * Executa em O((V + E) log V).
+            *
+            * @return Floresta geradora.
+            ***********************************************************************************************/
+			spanningForest getLowStretchSpanningForest() const;
+
+
+           /***********************************************************************************************
+            * Getter para uma base de ciclos curtos de um objeto da classe incidenceMatrix.
+            *
+            * Aproximação do algoritmo de Horton para a base de ciclos de peso mínimo: os candidatos são
+            * os ciclos que passam pela raiz de uma busca em largura de profundidade limitada a partir
+            * de cada vértice, além dos ciclos fundamentais de reference, que garantem uma base
+            * completa. Em ordem crescente de comprimento, cada candidato é aceito se for independente
+            * dos já aceitos, o que é verificado por eliminação sobre GF(2) com os ciclos representados
+            * como vetores de bits das cordas de reference. A eliminação custa O(N² N/64) no pior caso,
+            * com N o número de cordas.
+            *
+            * @param reference Floresta geradora do grafo.
+            * @param radius Profundidade das buscas que geram os candidatos.
+            *
+            * @return Ciclos da base, tantos quantos as cordas de reference, no formato de
+            * getFundamentalLoop.
+            ***********************************************************************************************/
+			std::vector<std::vector<std::pair<unsigned int, int>>> getShortCycleBasis(const spanningForest &reference,
+			                                                                          unsigned int radius) const;
+
+
+           /***********************************************************************************************
+            * Getter para o ciclo fundamental de uma corda de um objeto da classe incidenceMatrix.
+            *
+            * O ciclo é formado pela corda e pelo caminho, na floresta, entre os seus extremos: ambos
+            * sobem pelos pais até o menor ancestral comum. O custo é proporcional ao comprimento do
+            * ciclo, e o método pode ser chamado concorrentemente para cordas diferentes.
+            *
+            * @param forest Floresta geradora obtida por getSpanningForest.
+            * @param chord Aresta fora da floresta.
+            * @param loop Vector que recebe as arestas do ciclo, em ordem crescente, cada uma com 1 se
+            * é percorrida na sua direção ou -1 caso contrário. A corda é percorrida na sua direção.
+            *
+            * @return Void.
+            ***********************************************************************************************/
+			void getFundamentalLoop(const spanningForest &forest, unsigned int chord,
+			                        std::vector<std::pair<unsigned int, int>> &loop) const;
+
+
            /***********************************************************************************************
             * Getter para um vértice de um objeto da classe incidenceMatrix.
             *
-            * Retorna o vértice conectado a vtx pela aresta edge.
+            * Retorna o vértice conectado a vtx pela aresta edge, em O(1).
             *
             * @param vtx Vértice pertencente ao grafo.
             * @param edge Aresta pertencente ao grafo.
@@ -188,7 +360,8 @@ namespace GRF{
            /***********************************************************************************************
             * Getter para as arestas de um vértice de um objeto da classe incidenceMatrix.
             *
-            * Retorna todas as arestas que conectam vtx a algum outro vértice.
+            * Retorna todas as arestas que conectam vtx a algum outro vértice, em ordem crescente, em
+            * O(grau de vtx).
             *
             * @param vtx Vértice pertencente ao grafo.
             *
@@ -200,7 +373,7 @@ namespace GRF{
            /***********************************************************************************************
             * Getter para as arestas que conectam dois vértices de um objeto da classe incidenceMatrix.
             *
-            * Retorna todas as arestas que conectam vtx1 e vtx2.
+            * Retorna todas as arestas que conectam vtx1 e vtx2, em O(grau de vtx1 + grau de vtx2).
             *
             * @param vtx1 Vértice pertencente ao grafo.
             * @param vtx2 Vértice pertencente ao grafo.
@@ -217,7 +390,7 @@ namespace GRF{
             *
             * std::pair contendo os 2 vértices que estão conectados por edge. O primeiro elemento do pair é o
             * vértice de saída enquanto que o segundo elemento do pair é o vértice de entrada da conexão. Caso
-            * não haja conexão, retorna o par (0,0).
+            * não haja conexão, retorna o par (0,0). Executa em O(1).
             *
             * @param edge Aresta pertencente ao grafo.
             *
@@ -229,7 +402,7 @@ namespace GRF{
            /*****************************************************************************************************
             * Getter para o número de conexões de um vértice de um objeto da classe incidenceMatrix.
             *
-            * Retorna o número de conexões que um vértice pertencente ao grafo possui.
+            * Retorna o número de conexões que um vértice pertencente ao grafo possui, em O(1).
             *
             * @param vtx Vértice pertencente ao grafo.
             *
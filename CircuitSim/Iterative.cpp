@@ -0,0 +1,554 @@
+/********************************************************************************************
+ * @file Iterative.cpp
+ * @authors: Lucas Carvalho; Rafael Marasca Martins
+ * @date: 18 10 2026
+ * @brief Implementação dos métodos iterativos e precondicionadores.
+ *
+ * Este arquivo contém as implementações dos operadores lineares, das classes de
+ * precondicionadores, do método do gradiente conjugado precondicionado e do método de
+ * Gauss-Seidel multicolorido com sobre-relaxação.
+ *
+ ********************************************************************************************/
+
+#include "Iterative.h"
+#include "Backend.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace NM {
+
+	//  Produto interno de dois vetores contíguos.
+	static double dot(const double *a, const double *b, unsigned int n) {
+		double s0 = 0, s1 = 0;
+		unsigned int i = 0;
+		for(; i + 2 <= n; i += 2) {
+			s0 += a[i] * b[i];
+			s1 += a[i + 1] * b[i + 1];
+		}
+		if(i < n)
+			s0 += a[i] * b[i];
+		return s0 + s1;
+	}
+
+	LinearOperator::~LinearOperator() {}
+
+	SparseOperator::SparseOperator(const SparseMatrix &a) : A(a) {
+		if(a.getRowNumber() != a.getColNumber())
+			throw std::string("Matriz nao quadrada");
+	}
+
+	unsigned int SparseOperator::getSize() const { return A.getRowNumber(); }
+
+	void SparseOperator::apply(const double *x, double *y) const { A.multiply(x, y); }
+
+	void SparseOperator::getDiagonal(double *d) const {
+		for(unsigned int i = 0; i < A.getRowNumber(); i++)
+			d[i] = A.get(i, i);
+	}
+
+	DenseOperator::DenseOperator(const Matrix &a) : A(a) {
+		if(a.getRowNumber() != a.getColNumber())
+			throw std::string("Matriz nao quadrada");
+	}
+
+	unsigned int DenseOperator::getSize() const { return A.getRowNumber(); }
+
+	void DenseOperator::apply(const double *x, double *y) const {
+		const unsigned int n = A.getRowNumber();
+		for(unsigned int i = 0; i < n; i++)
+			y[i] = dot(&A(i, 0), x, n);
+	}
+
+	void DenseOperator::getDiagonal(double *d) const {
+		for(unsigned int i = 0; i < A.getRowNumber(); i++)
+			d[i] = A(i, i);
+	}
+
+	Preconditioner::~Preconditioner() {}
+
+	void JacobiPreconditioner::setup(const SparseMatrix &a) {
+		invDiag.assign(a.getRowNumber(), 0);
+		for(unsigned int i = 0; i < a.getRowNumber(); i++) {
+			const double d = a.get(i, i);
+			//  Linhas com diagonal nula (malhas só de fios) não são atualizadas.
+			invDiag[i] = (d == 0) ? 0 : 1 / d;
+		}
+	}
+
+	void JacobiPreconditioner::setup(const LinearOperator &op) {
+		invDiag.assign(op.getSize(), 0);
+		op.getDiagonal(invDiag.data());
+		for(unsigned int i = 0; i < invDiag.size(); i++)
+			invDiag[i] = (invDiag[i] == 0) ? 0 : 1 / invDiag[i];
+	}
+
+	void JacobiPreconditioner::apply(const double *r, double *z) const {
+		for(unsigned int i = 0; i < invDiag.size(); i++)
+			z[i] = invDiag[i] * r[i];
+	}
+
+	SSORPreconditioner::SSORPreconditioner(double w) : omega(w) {
+		if(w <= 0 or w >= 2)
+			throw std::string("Fator de relaxacao invalido");
+	}
+
+	void SSORPreconditioner::setup(const SparseMatrix &a) {
+		A = a;
+		const IndexVector &rp = A.getRowPtr();
+		const IndexVector &ci = A.getColIndex();
+
+		diag.assign(A.getRowNumber(), 0);
+		diagPos.assign(A.getRowNumber(), 0);
+		for(unsigned int i = 0; i < A.getRowNumber(); i++) {
+			//  As colunas de cada linha estão ordenadas: a diagonal separa L de U.
+			diagPos[i] = std::lower_bound(ci.begin() + rp[i], ci.begin() + rp[i + 1], i) - ci.begin();
+			if(diagPos[i] < rp[i + 1] and ci[diagPos[i]] == i)
+				diag[i] = A.getValues()[diagPos[i]];
+		}
+	}
+
+	//  z = w(2 - w) (D + wU)^-1 D (D + wL)^-1 r, com uma varredura direta e outra reversa.
+	void SSORPreconditioner::apply(const double *r, double *z) const {
+		const unsigned int n = A.getRowNumber();
+		const IndexVector &rp = A.getRowPtr();
+		const IndexVector &ci = A.getColIndex();
+		const double *v = A.getValues();
+
+		for(unsigned int i = 0; i < n; i++) {
+			if(diag[i] == 0) {
+				z[i] = 0;
+				continue;
+			}
+			double s = r[i];
+			for(unsigned int k = rp[i]; k < diagPos[i]; k++)
+				s -= omega * v[k] * z[ci[k]];
+			z[i] = s / diag[i];
+		}
+
+		for(unsigned int i = 0; i < n; i++)
+			z[i] *= diag[i];
+
+		for(unsigned int i = n; i-- > 0;) {
+			if(diag[i] == 0) {
+				z[i] = 0;
+				continue;
+			}
+			double s = z[i];
+			for(unsigned int k = diagPos[i]; k < rp[i + 1]; k++)
+				if(ci[k] != i)
+					s -= omega * v[k] * z[ci[k]];
+			z[i] = s / diag[i];
+		}
+
+		const double scale = omega * (2 - omega);
+		for(unsigned int i = 0; i < n; i++)
+			z[i] *= scale;
+	}
+
+	IC0Preconditioner::IC0Preconditioner() : shift(0) {}
+
+	//  Fatoração incompleta por linhas: L(i, k) só é calculado para as posições (i, k)
+	//presentes em A, e os produtos internos percorrem a interseção das linhas i e k.
+	bool IC0Preconditioner::factorize(const SparseMatrix &a, double alpha) {
+		const unsigned int n = a.getRowNumber();
+		const IndexVector &rp = a.getRowPtr();
+		const IndexVector &ci = a.getColIndex();
+		const double *av = a.getValues();
+
+		std::vector<Triplet> lower;
+		for(unsigned int i = 0; i < n; i++)
+			for(unsigned int k = rp[i]; k < rp[i + 1]; k++)
+				if(ci[k] < i)
+					lower.push_back({i, ci[k], av[k]});
+		L = SparseMatrix(n, n, lower);
+
+		const IndexVector &lp = L.getRowPtr();
+		const IndexVector &li = L.getColIndex();
+		double *lx = L.getValues();
+		D.assign(n, 0);
+
+		for(unsigned int i = 0; i < n; i++) {
+			for(unsigned int p = lp[i]; p < lp[i + 1]; p++) {
+				const unsigned int k = li[p];
+				double t = lx[p];
+
+				//  Interseção ordenada das linhas i e k, restrita às colunas menores que k.
+				unsigned int q = lp[i], r = lp[k];
+				while(q < p and r < lp[k + 1]) {
+					if(li[q] < li[r])
+						q++;
+					else if(li[q] > li[r])
+						r++;
+					else {
+						t -= lx[q] * D[li[q]] * lx[r];
+						q++;
+						r++;
+					}
+				}
+				lx[p] = (D[k] == 0) ? 0 : t / D[k];
+			}
+
+			const double aii = a.get(i, i);
+			double d = aii * (1 + alpha);
+			for(unsigned int p = lp[i]; p < lp[i + 1]; p++)
+				d -= lx[p] * lx[p] * D[li[p]];
+
+			if(aii == 0)
+				d = 0;
+			else if(d <= 0)
+				return false;
+			D[i] = d;
+		}
+		return true;
+	}
+
+	void IC0Preconditioner::setup(const SparseMatrix &a) {
+		shift = 0;
+		while(not factorize(a, shift)) {
+			shift = (shift == 0) ? 1e-3 : 2 * shift;
+			if(shift > 1e3)
+				throw std::string("Fatoracao incompleta falhou");
+		}
+	}
+
+	void IC0Preconditioner::apply(const double *r, double *z) const {
+		const unsigned int n = D.size();
+		const IndexVector &lp = L.getRowPtr();
+		const IndexVector &li = L.getColIndex();
+		const double *lx = L.getValues();
+
+		for(unsigned int i = 0; i < n; i++) {
+			double s = r[i];
+			for(unsigned int p = lp[i]; p < lp[i + 1]; p++)
+				s -= lx[p] * z[li[p]];
+			z[i] = s;
+		}
+
+		for(unsigned int i = 0; i < n; i++)
+			z[i] = (D[i] == 0) ? 0 : z[i] / D[i];
+
+		//  Substituição reversa com Lt, orientada pelas linhas de L.
+		for(unsigned int i = n; i-- > 0;)
+			for(unsigned int p = lp[i]; p < lp[i + 1]; p++)
+				z[li[p]] -= lx[p] * z[i];
+	}
+
+	double IC0Preconditioner::getShift() const { return shift; }
+
+	ConjugateGradient::ConjugateGradient(double tol, unsigned int maxIter, const Preconditioner *p, Workspace *w)
+		: tolerance(tol), maxIterations(maxIter), preconditioner(p), report({CONJUGATE_GRADIENT_SOLVER, 0, 0, 0, false, getBackend().getName(), 0, 0}),
+		  workspace(w == nullptr ? &ownWorkspace : w) {}
+
+	void ConjugateGradient::run(const LinearOperator &op, const double *b, double *x) {
+		const unsigned int n = op.getSize();
+		double *r = workspace->get<double>(CG_RESIDUAL_SLOT, n);
+		double *z = workspace->get<double>(CG_PRECONDITIONED_SLOT, n);
+		double *p = workspace->get<double>(CG_DIRECTION_SLOT, n);
+		double *q = workspace->get<double>(CG_PRODUCT_SLOT, n);
+
+		const double normB = std::sqrt(dot(b, b, n));
+		if(normB == 0) {
+			std::fill(x, x + n, 0.0);
+			return;
+		}
+
+		//  r = b - A*x
+		op.apply(x, q);
+		for(unsigned int i = 0; i < n; i++)
+			r[i] = b[i] - q[i];
+
+		if(preconditioner)
+			preconditioner->apply(r, z);
+		else
+			std::copy(r, r + n, z);
+
+		std::copy(z, z + n, p);
+		double rz = dot(r, z, n);
+		double residual = std::sqrt(dot(r, r, n)) / normB;
+		unsigned int k = 0;
+
+		while(residual > tolerance and k < maxIterations) {
+			op.apply(p, q);
+			const double pq = dot(p, q, n);
+
+			//  Direção sem curvatura: o método não pode prosseguir.
+			if(pq <= 0)
+				break;
+
+			const double alpha = rz / pq;
+			for(unsigned int i = 0; i < n; i++) {
+				x[i] += alpha * p[i];
+				r[i] -= alpha * q[i];
+			}
+			k++;
+
+			residual = std::sqrt(dot(r, r, n)) / normB;
+			if(residual <= tolerance)
+				break;
+
+			if(preconditioner)
+				preconditioner->apply(r, z);
+			else
+				std::copy(r, r + n, z);
+
+			const double rzNew = dot(r, z, n);
+			const double beta = rzNew / rz;
+			rz = rzNew;
+			for(unsigned int i = 0; i < n; i++)
+				p[i] = z[i] + beta * p[i];
+		}
+
+		report.iterations = std::max(report.iterations, k);
+		report.residual = std::max(report.residual, residual);
+		report.converged = report.converged and residual <= tolerance;
+	}
+
+	SolverReport ConjugateGradient::solve(const LinearOperator &op, const Matrix &b, Matrix &x) {
+		const unsigned int n = op.getSize();
+		if(b.getRowNumber() != n)
+			throw std::string("Matrizes incompativeis.");
+
+		if(x.getRowNumber() != n or x.getColNumber() != b.getColNumber())
+			x.resize(n, b.getColNumber());
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		report = {CONJUGATE_GRADIENT_SOLVER, 0, 0, 0, true, getBackend().getName(), 0, 0};
+
+		double *bc = workspace->get<double>(CG_RHS_SLOT, n);
+		double *xc = workspace->get<double>(CG_SOLUTION_SLOT, n);
+		for(unsigned int c = 0; c < b.getColNumber(); c++) {
+			for(unsigned int i = 0; i < n; i++) {
+				bc[i] = b(i, c);
+				xc[i] = x(i, c);
+			}
+			run(op, bc, xc);
+			for(unsigned int i = 0; i < n; i++)
+				x(i, c) = xc[i];
+		}
+
+		report.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return report;
+	}
+
+	SolverReport ConjugateGradient::solve(const SparseMatrix &a, const Matrix &b, Matrix &x) {
+		return solve(SparseOperator(a), b, x);
+	}
+
+	SolverReport ConjugateGradient::solve(const Matrix &a, const Matrix &b, Matrix &x) {
+		return solve(DenseOperator(a), b, x);
+	}
+
+	const SolverReport &ConjugateGradient::getReport() const { return report; }
+
+	//  Linhas relaxadas por tarefa em cada cor. O tamanho não depende do número de 
+	//threads; como as linhas de uma cor são independentes, o resultado também não.
+	static const unsigned int sorChunk = 512;
+
+	MulticolorSOR::MulticolorSOR(double tol, unsigned int maxIter, double w)
+		: tolerance(tol), maxIterations(maxIter), fixedOmega(w), omega(w == 0 ? 1 : w), report({GAUSS_SEIDEL_SOLVER, 0, 0, 0, false, getBackend().getName(), 0, 0}) {
+		if(w < 0 or w >= 2)
+			throw std::string("Fator de relaxacao invalido");
+	}
+
+	void MulticolorSOR::setup(const SparseMatrix &a) {
+		const unsigned int n = a.getRowNumber();
+		if(n != a.getColNumber())
+			throw std::string("Matriz nao quadrada");
+
+		A = a;
+		const IndexVector &rp = A.getRowPtr();
+		const IndexVector &ci = A.getColIndex();
+
+		invDiag.assign(n, 0);
+		for(unsigned int i = 0; i < n; i++) {
+			const double d = A.get(i, i);
+			//  Linhas com diagonal nula (malhas só de fios) não são atualizadas.
+			invDiag[i] = (d == 0) ? 0 : 1 / d;
+		}
+
+		//  Padrão transposto: a linha i lê x(j) se A(i, j) != 0, e a linha j lê x(i) se
+		//A(j, i) != 0. Em ambos os casos i e j precisam de cores diferentes.
+		std::vector<unsigned int> tp(n + 1, 0), ti(ci.size());
+		for(unsigned int k = 0; k < ci.size(); k++)
+			tp[ci[k] + 1]++;
+		for(unsigned int i = 0; i < n; i++)
+			tp[i + 1] += tp[i];
+		std::vector<unsigned int> fill(tp.begin(), tp.end() - 1);
+		for(unsigned int i = 0; i < n; i++)
+			for(unsigned int k = rp[i]; k < rp[i + 1]; k++)
+				ti[fill[ci[k]]++] = i;
+
+		//  Coloração gulosa: cada incógnita recebe a menor cor ausente entre os vizinhos
+		//já coloridos. forbidden[c] == i marca a cor c como usada por um vizinho de i.
+		const unsigned int none = static_cast<unsigned int>(-1);
+		std::vector<unsigned int> color(n, none), forbidden;
+		unsigned int colors = 0;
+		for(unsigned int i = 0; i < n; i++) {
+			for(unsigned int k = rp[i]; k < rp[i + 1]; k++)
+				if(color[ci[k]] != none)
+					forbidden[color[ci[k]]] = i;
+			for(unsigned int k = tp[i]; k < tp[i + 1]; k++)
+				if(color[ti[k]] != none)
+					forbidden[color[ti[k]]] = i;
+
+			unsigned int c = 0;
+			while(c < colors and forbidden[c] == i)
+				c++;
+			if(c == colors) {
+				colors++;
+				forbidden.push_back(none);
+			}
+			color[i] = c;
+		}
+
+		//  Agrupa as linhas por cor (mantendo a ordem natural dentro de cada cor) e divide
+		//cada cor em blocos.
+		std::vector<unsigned int> colorPtr(colors + 1, 0);
+		for(unsigned int i = 0; i < n; i++)
+			colorPtr[color[i] + 1]++;
+		for(unsigned int c = 0; c < colors; c++)
+			colorPtr[c + 1] += colorPtr[c];
+
+		order.resize(n);
+		fill.assign(colorPtr.begin(), colorPtr.end() - 1);
+		for(unsigned int i = 0; i < n; i++)
+			order[fill[color[i]]++] = i;
+
+		chunkPtr.clear();
+		colorChunks.assign(colors + 1, 0);
+		for(unsigned int c = 0; c < colors; c++) {
+			colorChunks[c] = chunkPtr.size();
+			for(unsigned int k = colorPtr[c]; k < colorPtr[c + 1]; k += sorChunk)
+				chunkPtr.push_back(k);
+		}
+		colorChunks[colors] = chunkPtr.size();
+		chunkPtr.push_back(n);
+
+		chunkChange.assign(chunkPtr.size() - 1, 0);
+		xc.assign(n, 0);
+		bc.assign(n, 0);
+	}
+
+	void MulticolorSOR::run() {
+		const unsigned int colors = colorChunks.size() - 1;
+		const IndexVector &rp = A.getRowPtr();
+		const IndexVector &ci = A.getColIndex();
+		const double *v = A.getValues();
+		ThreadPool &pool = getThreadPool();
+
+		//  O corpo do laço paralelo é construído uma única vez; color e w são lidos a 
+		//cada varredura.
+		unsigned int color = 0;
+		double w = omega;
+		const std::function<void(unsigned int)> relax = [&](unsigned int t) {
+			const unsigned int chunk = colorChunks[color] + t;
+			double change = 0;
+			for(unsigned int k = chunkPtr[chunk]; k < chunkPtr[chunk + 1]; k++) {
+				const unsigned int i = order[k];
+				if(invDiag[i] == 0) {
+					xc[i] = 0;
+					continue;
+				}
+				double s = bc[i];
+				for(unsigned int p = rp[i]; p < rp[i + 1]; p++)
+					s -= v[p] * xc[ci[p]];
+				const double dx = w * s * invDiag[i];
+				xc[i] += dx;
+				change = std::max(change, std::fabs(dx));
+			}
+			chunkChange[chunk] = change;
+		};
+
+		const bool adaptive = (fixedOmega == 0);
+		bool estimating = adaptive and omega == 1;
+		double previous = 0, previousRatio = 0, best = std::numeric_limits<double>::max();
+		unsigned int k = 0;
+		double biggest = 0;
+
+		while(k < maxIterations) {
+			for(color = 0; color < colors; color++)
+				pool.parallelFor(colorChunks[color + 1] - colorChunks[color], relax);
+			k++;
+
+			//  Critério de parada do método de Gauss-Seidel: maior correção da iteração.
+			biggest = 0;
+			for(unsigned int c = 0; c < chunkChange.size(); c++)
+				biggest = std::max(biggest, chunkChange[c]);
+			if(biggest < tolerance)
+				break;
+
+			if(adaptive and previous > 0) {
+				const double ratio = biggest / previous;
+				if(estimating) {
+					//  A razão entre correções sucessivas de Gauss-Seidel tende ao raio
+					//espectral da iteração; quando ela se estabiliza, w é ajustado.
+					if(ratio < 1 and k > 3 and std::fabs(ratio - previousRatio) < 1e-2 * (1 - ratio)) {
+						w = std::min(1.95, 2 / (1 + std::sqrt(1 - ratio)));
+						estimating = false;
+						best = biggest;
+					}
+					previousRatio = ratio;
+				}
+				else if(w != 1) {
+					//  Correções muito maiores que a menor já vista indicam divergência.
+					best = std::min(best, biggest);
+					if(biggest > 100 * best)
+						w = 1;
+				}
+			}
+			previous = biggest;
+		}
+
+		omega = w;
+		report.iterations = std::max(report.iterations, k);
+		report.converged = report.converged and biggest < tolerance;
+	}
+
+	SolverReport MulticolorSOR::solve(const Matrix &b, Matrix &x) {
+		const unsigned int n = xc.size();
+		if(b.getRowNumber() != n)
+			throw std::string("Matrizes incompativeis.");
+
+		if(x.getRowNumber() != n or x.getColNumber() != b.getColNumber())
+			x.resize(n, b.getColNumber());
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		report = {GAUSS_SEIDEL_SOLVER, 0, 0, 0, true, getBackend().getName(), 0, 0};
+
+		double r2 = 0, b2 = 0;
+		for(unsigned int c = 0; c < b.getColNumber(); c++) {
+			for(unsigned int i = 0; i < n; i++) {
+				bc[i] = b(i, c);
+				xc[i] = x(i, c);
+			}
+			run();
+			for(unsigned int i = 0; i < n; i++)
+				x(i, c) = xc[i];
+
+			//  Resíduo da coluna, linha a linha, sem vetor auxiliar.
+			const IndexVector &rp = A.getRowPtr();
+			const IndexVector &ci = A.getColIndex();
+			const double *v = A.getValues();
+			for(unsigned int i = 0; i < n; i++) {
+				double s = bc[i];
+				for(unsigned int p = rp[i]; p < rp[i + 1]; p++)
+					s -= v[p] * xc[ci[p]];
+				r2 += s * s;
+				b2 += bc[i] * bc[i];
+			}
+		}
+
+		report.residual = (b2 == 0) ? std::sqrt(r2) : std::sqrt(r2 / b2);
+		report.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return report;
+	}
+
+	unsigned int MulticolorSOR::getColorCount() const { return colorChunks.empty() ? 0 : colorChunks.size() - 1; }
+	double MulticolorSOR::getOmega() const { return omega; }
+	const SolverReport &MulticolorSOR::getReport() const { return report; }
+}
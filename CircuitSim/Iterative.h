@@ -0,0 +1,418 @@
+/********************************************************************************************
+ * @file Iterative.h
+ * @authors: Lucas Carvalho; Rafael Marasca Martins
+ * @date: 18 10 2026
+ * @brief Declaração dos métodos iterativos e precondicionadores.
+ *
+ * Este arquivo contém as declarações dos operadores lineares, das classes de
+ * precondicionadores, do método do gradiente conjugado precondicionado e do método de
+ * Gauss-Seidel multicolorido com sobre-relaxação.
+ *
+ * Os métodos deste arquivo operam tanto sobre matrizes densas (Matrix) quanto sobre
+ * matrizes esparsas (SparseMatrix) e são utilizados pela classe EquationSystem.
+ *
+ ********************************************************************************************/
+
+#ifndef ITERATIVE_H
+#define ITERATIVE_H
+
+#include "Numeric.h"
+
+#include <vector>
+
+namespace NM {
+
+   /*************************************************************************
+    * Declaração da classe abstrata LinearOperator.
+    *
+    * Representa um operador linear quadrado pela sua aplicação y = A*x,
+    * sem exigir que a matriz A exista explicitamente na memória. É a
+    * interface consumida pelos métodos iterativos.
+    *************************************************************************/
+	class LinearOperator {
+	public:
+	   /******************************************************************************************
+        * Desconstrutor virtual da classe LinearOperator.
+        ******************************************************************************************/
+		virtual ~LinearOperator();
+
+	   /******************************************************************************************
+        * Getter para a dimensão do operador.
+        *
+        * @return Número de linhas (e de colunas) de A.
+        ******************************************************************************************/
+		virtual unsigned int getSize() const = 0;
+
+	   /******************************************************************************************
+        * Aplica o operador.
+        *
+        * Calcula y = A*x. Os vetores não podem se sobrepor.
+        *
+        * @param x Vetor de entrada, com getSize() elementos.
+        * @param y Vetor de saída, com getSize() elementos.
+		*
+        * @return Void.
+        ******************************************************************************************/
+		virtual void apply(const double *x, double *y) const = 0;
+
+	   /******************************************************************************************
+        * Getter para a diagonal do operador.
+        *
+        * Usado pelo precondicionador de Jacobi.
+        *
+        * @param d Vetor que recebe as getSize() entradas da diagonal.
+		*
+        * @return Void.
+        ******************************************************************************************/
+		virtual void getDiagonal(double *d) const = 0;
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe SparseOperator.
+    *
+    * Operador linear definido por uma matriz esparsa, sem cópia.
+    *************************************************************************/
+	class SparseOperator : public LinearOperator {
+	private:
+		const SparseMatrix &A; /**< Matriz do operador.*/
+
+	public:
+	   /******************************************************************************************
+        * Construtor da classe SparseOperator.
+        *
+        * @param a Matriz esparsa quadrada, que deve existir enquanto o operador for usado.
+        ******************************************************************************************/
+		explicit SparseOperator(const SparseMatrix &a);
+
+		unsigned int getSize() const override;
+		void apply(const double *x, double *y) const override;
+		void getDiagonal(double *d) const override;
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe DenseOperator.
+    *
+    * Operador linear definido por uma matriz densa, sem cópia.
+    *************************************************************************/
+	class DenseOperator : public LinearOperator {
+	private:
+		const Matrix &A; /**< Matriz do operador.*/
+
+	public:
+	   /******************************************************************************************
+        * Construtor da classe DenseOperator.
+        *
+        * @param a Matriz densa quadrada, que deve existir enquanto o operador for usado.
+        ******************************************************************************************/
+		explicit DenseOperator(const Matrix &a);
+
+		unsigned int getSize() const override;
+		void apply(const double *x, double *y) const override;
+		void getDiagonal(double *d) const override;
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe abstrata Preconditioner.
+    *
+    * Representa um precondicionador M ~ A: após a preparação (setup),
+    * apply calcula z = M^-1 * r de forma barata.
+    *************************************************************************/
+	class Preconditioner {
+	public:
+	   /******************************************************************************************
+        * Desconstrutor virtual da classe Preconditioner.
+        ******************************************************************************************/
+		virtual ~Preconditioner();
+
+	   /******************************************************************************************
+        * Prepara o precondicionador para uma matriz.
+        *
+        * @param a Matriz simétrica do sistema.
+		*
+        * @return Void.
+        ******************************************************************************************/
+		virtual void setup(const SparseMatrix &a) = 0;
+
+	   /******************************************************************************************
+        * Aplica o precondicionador.
+        *
+        * Calcula z = M^-1 * r. Os vetores não podem se sobrepor.
+        *
+        * @param r Vetor de entrada.
+        * @param z Vetor de saída.
+		*
+        * @return Void.
+        ******************************************************************************************/
+		virtual void apply(const double *r, double *z) const = 0;
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe JacobiPreconditioner.
+    *
+    * Precondicionador diagonal: M = diag(A).
+    *************************************************************************/
+	class JacobiPreconditioner : public Preconditioner {
+	private:
+		std::vector<double> invDiag; /**< Inversos das entradas da diagonal (zero para diagonais nulas).*/
+
+	public:
+		void setup(const SparseMatrix &a) override;
+
+	   /******************************************************************************************
+        * Prepara o precondicionador a partir da diagonal de um operador.
+        *
+        * Permite precondicionar operadores cuja matriz não existe explicitamente.
+        *
+        * @param op Operador linear.
+		*
+        * @return Void.
+		*
+		* @overload
+        ******************************************************************************************/
+		void setup(const LinearOperator &op);
+		void apply(const double *r, double *z) const override;
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe SSORPreconditioner.
+    *
+    * Precondicionador de sobre-relaxação sucessiva simétrica:
+    * M = (D + wL) D^-1 (D + wU) / (w(2 - w)).
+    *************************************************************************/
+	class SSORPreconditioner : public Preconditioner {
+	private:
+		SparseMatrix A; /**< Cópia da matriz do sistema.*/
+		std::vector<double> diag; /**< Diagonal da matriz do sistema.*/
+		std::vector<unsigned int> diagPos; /**< Posição da diagonal em cada linha de A.*/
+		double omega; /**< Fator de relaxação.*/
+
+	public:
+	   /******************************************************************************************
+        * Construtor da classe SSORPreconditioner.
+        *
+        * @param w Fator de relaxação, entre 0 e 2.
+        ******************************************************************************************/
+		explicit SSORPreconditioner(double w = 1.0);
+
+		void setup(const SparseMatrix &a) override;
+		void apply(const double *r, double *z) const override;
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe IC0Preconditioner.
+    *
+    * Fatoração de Cholesky incompleta sem preenchimento, IC(0), na forma
+    * M = L*D*Lt: L tem o mesmo padrão da parte inferior de A. Se a
+    * fatoração encontrar um pivô não positivo, ela é refeita sobre
+    * A + a*diag(A), com a crescente (deslocamento de Manteuffel).
+    *************************************************************************/
+	class IC0Preconditioner : public Preconditioner {
+	private:
+		SparseMatrix L; /**< Parte estritamente inferior do fator, em CSR.*/
+		std::vector<double> D; /**< Diagonal do fator (zero para linhas nulas).*/
+		double shift; /**< Deslocamento diagonal usado na última fatoração.*/
+
+	   /******************************************************************************************
+        * Tenta a fatoração incompleta com um deslocamento diagonal.
+        *
+        * @param a Matriz do sistema.
+        * @param alpha Deslocamento relativo da diagonal.
+		*
+        * @return true se todos os pivôs foram positivos.
+        ******************************************************************************************/
+		bool factorize(const SparseMatrix &a, double alpha);
+
+	public:
+		IC0Preconditioner();
+
+		void setup(const SparseMatrix &a) override;
+		void apply(const double *r, double *z) const override;
+
+	   /******************************************************************************************
+        * Getter para o deslocamento diagonal.
+        *
+        * @return Deslocamento relativo usado na fatoração (zero se não foi necessário).
+        ******************************************************************************************/
+		double getShift() const;
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe ConjugateGradient.
+    *
+    * Implementa o método do gradiente conjugado precondicionado para
+    * sistemas simétricos positivos (semi)definidos, dados por matrizes
+    * densas, esparsas ou por um operador linear qualquer.
+    *************************************************************************/
+	class ConjugateGradient {
+	private:
+		double tolerance; /**< Tolerância para o resíduo relativo.*/
+		unsigned int maxIterations; /**< Número máximo de iterações.*/
+		const Preconditioner *preconditioner; /**< Precondicionador (nulo para nenhum).*/
+		SolverReport report; /**< Relatório da última solução.*/
+		Workspace ownWorkspace; /**< Memória de trabalho usada quando nenhuma é fornecida.*/
+		Workspace *workspace; /**< Memória de trabalho dos vetores do método.*/
+
+	   /******************************************************************************************
+        * Laço do gradiente conjugado para um único lado direito.
+        *
+        * @param op Operador do sistema.
+        * @param b Lado direito.
+        * @param x Chute inicial, sobrescrito pela solução.
+		*
+        * @return Void.
+        ******************************************************************************************/
+		void run(const LinearOperator &op, const double *b, double *x);
+
+	public:
+	   /******************************************************************************************
+        * Construtor da classe ConjugateGradient.
+        *
+        * @param tol Tolerância para o resíduo relativo ||b - A*x|| / ||b||.
+        * @param maxIter Número máximo de iterações.
+        * @param p Precondicionador já preparado, ou nulo.
+        * @param w Memória de trabalho compartilhada entre soluções, ou nulo para uma própria.
+        *          Com uma memória já usada em um sistema de mesma dimensão, a solução não
+        *          aloca.
+        ******************************************************************************************/
+		ConjugateGradient(double tol, unsigned int maxIter, const Preconditioner *p = nullptr, Workspace *w = nullptr);
+
+		ConjugateGradient(const ConjugateGradient &) = delete;
+		ConjugateGradient &operator=(const ConjugateGradient &) = delete;
+
+	   /******************************************************************************************
+        * Resolve um sistema definido por um operador linear.
+        *
+        * @param op Operador simétrico positivo (semi)definido.
+        * @param b Lados direitos (uma coluna por sistema).
+        * @param x Chutes iniciais, sobrescritos pelas soluções.
+		*
+        * @return Relatório da solução.
+        ******************************************************************************************/
+		SolverReport solve(const LinearOperator &op, const Matrix &b, Matrix &x);
+
+	   /******************************************************************************************
+        * Resolve um sistema esparso.
+        *
+        * @param a Matriz esparsa simétrica.
+        * @param b Lados direitos (uma coluna por sistema).
+        * @param x Chutes iniciais, sobrescritos pelas soluções.
+		*
+        * @return Relatório da solução.
+		*
+		* @overload
+        ******************************************************************************************/
+		SolverReport solve(const SparseMatrix &a, const Matrix &b, Matrix &x);
+
+	   /******************************************************************************************
+        * Resolve um sistema denso.
+        *
+        * @param a Matriz densa simétrica.
+        * @param b Lados direitos (uma coluna por sistema).
+        * @param x Chutes iniciais, sobrescritos pelas soluções.
+		*
+        * @return Relatório da solução.
+		*
+		* @overload
+        ******************************************************************************************/
+		SolverReport solve(const Matrix &a, const Matrix &b, Matrix &x);
+
+	   /******************************************************************************************
+        * Getter para o relatório da última solução.
+        *
+        * @return Iterações, resíduo final e tempo da última solução.
+        ******************************************************************************************/
+		const SolverReport &getReport() const;
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe MulticolorSOR.
+    *
+    * Implementa o método de Gauss-Seidel com sobre-relaxação sucessiva
+    * (SOR) sobre uma ordenação multicolorida: as incógnitas são coloridas
+    * de forma que duas incógnitas acopladas por uma entrada da matriz nunca
+    * tenham a mesma cor. Todas as incógnitas de uma cor podem então ser
+    * relaxadas ao mesmo tempo, e cada cor é dividida em blocos fixos
+    * distribuídos entre as threads de getThreadPool(). Em malhas em grade a
+    * coloração gulosa produz a ordenação vermelho-preto.
+    *
+    * O fator de relaxação pode ser fixo ou adaptativo: no modo adaptativo,
+    * as primeiras iterações são de Gauss-Seidel (w = 1) e estimam o raio
+    * espectral rho da iteração pela razão entre correções sucessivas; o
+    * fator passa então a w = 2 / (1 + sqrt(1 - rho)), o ótimo para matrizes
+    * consistentemente ordenadas. Se as correções crescerem muito além da
+    * menor já observada, o método retorna a w = 1.
+    *
+    * Toda a memória de trabalho é reservada em setup(): as iterações não
+    * alocam memória.
+    *************************************************************************/
+	class MulticolorSOR {
+	private:
+		double tolerance; /**< Tolerância para a maior correção de uma iteração.*/
+		unsigned int maxIterations; /**< Número máximo de iterações.*/
+		double fixedOmega; /**< Fator de relaxação fixo (zero para adaptativo).*/
+		double omega; /**< Fator de relaxação da última solução.*/
+		SparseMatrix A; /**< Cópia da matriz do sistema.*/
+		std::vector<double> invDiag; /**< Inversos da diagonal (zero para linhas nulas).*/
+		std::vector<unsigned int> order; /**< Linhas agrupadas por cor.*/
+		std::vector<unsigned int> chunkPtr; /**< Início de cada bloco de linhas em order.*/
+		std::vector<unsigned int> colorChunks; /**< Primeiro bloco de cada cor.*/
+		std::vector<double> chunkChange; /**< Maior correção de cada bloco na varredura atual.*/
+		std::vector<double> xc; /**< Coluna da solução em iteração.*/
+		std::vector<double> bc; /**< Coluna do lado direito em iteração.*/
+		SolverReport report; /**< Relatório da última solução.*/
+
+	   /******************************************************************************************
+        * Laço do método para um único lado direito, em xc e bc.
+        *
+        * @return Void.
+        ******************************************************************************************/
+		void run();
+
+	public:
+	   /******************************************************************************************
+        * Construtor da classe MulticolorSOR.
+        *
+        * @param tol Tolerância para a maior correção de uma iteração, como no método de 
+		* Gauss-Seidel.
+        * @param maxIter Número máximo de iterações.
+        * @param w Fator de relaxação, entre 0 e 2. Zero escolhe o fator adaptativo.
+        ******************************************************************************************/
+		MulticolorSOR(double tol, unsigned int maxIter, double w = 0);
+
+	   /******************************************************************************************
+        * Prepara o método para uma matriz.
+        *
+        * Colore o grafo de adjacência da matriz (simetrizado) pelo algoritmo guloso e 
+		* reserva a memória de trabalho.
+        *
+        * @param a Matriz quadrada do sistema.
+		*
+        * @return Void.
+        ******************************************************************************************/
+		void setup(const SparseMatrix &a);
+
+	   /******************************************************************************************
+        * Resolve o sistema preparado em setup().
+        *
+        * @param b Lados direitos (uma coluna por sistema).
+        * @param x Chutes iniciais, sobrescritos pelas soluções.
+		*
+        * @return Relatório da solução. O resíduo é relativo à norma de b.
+        ******************************************************************************************/
+		SolverReport solve(const Matrix &b, Matrix &x);
+
+		unsigned int getColorCount() const; /**< Retorna o número de cores da ordenação.*/
+		double getOmega() const; /**< Retorna o fator de relaxação usado na última solução.*/
+		const SolverReport &getReport() const; /**< Retorna o relatório da última solução.*/
+	};
+}
+
+#endif
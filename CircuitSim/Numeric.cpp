@@ -12,283 +12,2190 @@
  ********************************************************************************************/
 
 #include "Numeric.h"
+#include "Backend.h"
+#include "FixedMatrix.h"
+#include "Iterative.h"
+#include "Gemm.h"
+#include "Planner.h"
+#include "ThreadPool.h"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <set>
 #include <string>
 
 namespace NM{
 
-	Matrix::Matrix(unsigned int r) {
-		rowNumber = r;
-		colNumber = 1;
-		realMatrix = std::vector<std::vector<double>>(r, std::vector<double>(1, 0));
+	//  A calibração só mede candidatos cujo custo estimado não passa deste múltiplo do
+	//custo do mais barato: o modelo erra por fatores pequenos, não por ordens de grandeza.
+	static const double maxCalibrationRatio = 100;
+
+	//  Segundos decorridos desde t.
+	static double secondsSince(std::chrono::steady_clock::time_point t) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count();
 	}
+
+	//  Número máximo de modificações acumuladas sobre uma fatoração LU. Cada solução paga
+	//O(n*k) a mais pela correção, e a capacitância k x k é refatorada a cada modificação.
+	static const unsigned int maxWoodburyRank = 32;
+
+	//  Uma modificação que leva uma entrada a menos que isto (relativo aos módulos somados)
+	//é um cancelamento: a entrada é zerada, como na montagem direta.
+	static const double cancellationTolerance = 64 * std::numeric_limits<double>::epsilon();
+
+	//  Produtos com menos operações que isto (m*n*k) usam o laço simples: abaixo de ~32³
+	//o empacotamento do algoritmo blocado custa mais do que economiza.
+	static const double gemmThreshold = 32.0 * 32.0 * 32.0;
+
+	//  Limite de passos do refinamento em precisão mista (o mesmo do dsgesv do LAPACK).
+	//Cada passo reduz o erro por um fator da ordem de cond(A)*eps(float); se isso não
+	//bastar, a fatoração em precisão dupla é mais barata que continuar.
+	static const unsigned int maxRefinementSteps = 30;
+
+	Matrix::Matrix(unsigned int r) : realMatrix(r, 0.0), rowNumber(r), colNumber(1) {}
+
 	//  Constrói uma matriz de tamanho R e C e preenche com zeros.
-	Matrix::Matrix(unsigned int r, unsigned int c) {
-		std::vector<std::vector<double>> aux(r, std::vector<double>(c, 0));
-		rowNumber = r;
-		colNumber = c;
-		realMatrix = aux;
+	Matrix::Matrix(unsigned int r, unsigned int c) : realMatrix(std::size_t(r) * c, 0.0), rowNumber(r), colNumber(c) {}
+
+	//  Copia os elementos de uma visão (que pode ter distâncias quaisquer) para um buffer novo.
+	Matrix::Matrix(const ConstMatrixView &v) : Matrix(v.getRowNumber(), v.getColNumber()) {
+		for(unsigned int i = 0; i < rowNumber; i++)
+			for(unsigned int j = 0; j < colNumber; j++)
+				(*this)(i, j) = v(i, j);
+	}
+
+	//  Descreve uma visão como operando do gemm de um backend: linhas contíguas (como está)
+	//ou colunas contíguas (transposta de uma matriz armazenada por linhas).
+	static bool backendOperand(const ConstMatrixView &v, transposeOperation &op, unsigned int &ld) {
+		if(v.getColStride() == 1 and v.getRowStride() >= std::ptrdiff_t(v.getColNumber())) {
+			op = NO_TRANSPOSE;
+			ld = v.getRowStride();
+			return true;
+		}
+		if(v.getRowStride() == 1 and v.getColStride() >= std::ptrdiff_t(v.getRowNumber())) {
+			op = TRANSPOSE;
+			ld = v.getColStride();
+			return true;
+		}
+		return false;
 	}
-	//  Multiplica duas matrizes com sobrecarga de operadores
-	Matrix Matrix::operator* (Matrix &m1) {
-		if(this->getColNumber() != m1.getRowNumber())
+
+	//  Produtos grandes usam o gemm do backend em uso (o algoritmo blocado de Gemm.cpp, no 
+	//backend embutido); visões com distâncias que a BLAS não descreve vão direto ao blocado.
+	//Nos pequenos, ordem i-k-j: a linha k de b e a linha i de c são percorridas no laço 
+	//interno, de forma contígua quando as visões não são transpostas.
+	void multiplyAdd(const ConstMatrixView &a, const ConstMatrixView &b, const MatrixView &c, double alpha) {
+		if(a.getColNumber() != b.getRowNumber() or c.getRowNumber() != a.getRowNumber() or c.getColNumber() != b.getColNumber())
 			throw std::string("Matrizes incompativeis.");
 
-		Matrix helper = (*this);
-		
-		//  A matriz resultante tem o número de linhas da matriz do LHS
-		//e o número de colunas da matriz do RHS.
-		Matrix result(helper.getRowNumber(), m1.getColNumber());
-		
-		//  Dois laços pra pegar o R(i, j)
-		for(unsigned int i = 0; i < result.getRowNumber(); i++) {
-			for(unsigned int j = 0; j < result.getColNumber(); j++) {
-				//  Laço pra somar as multiplicações de col x linha.
-				for(unsigned int k = 0; k < helper.getColNumber(); k++) {
-					result[i][j] += helper[i][k]*m1[k][j];
+		const unsigned int m = c.getRowNumber(), n = c.getColNumber(), p = a.getColNumber();
+		if(double(m) * n * p >= gemmThreshold) {
+			transposeOperation ta, tb;
+			unsigned int lda, ldb;
+			if(c.getColStride() == 1 and c.getRowStride() >= std::ptrdiff_t(n) and backendOperand(a, ta, lda) and backendOperand(b, tb, ldb))
+				getBackend().gemm(ta, tb, m, n, p, alpha, a.data(), lda, b.data(), ldb, 1.0, c.data(), c.getRowStride());
+			else
+				gemm(a, b, c, alpha);
+			return;
+		}
+
+		const bool contiguous = (b.getColStride() == 1 and c.getColStride() == 1);
+
+		for(unsigned int i = 0; i < m; i++) {
+			for(unsigned int k = 0; k < p; k++) {
+				const double aik = alpha * a(i, k);
+				if(aik == 0)
+					continue;
+
+				if(contiguous) {
+					const double *bk = &b(k, 0);
+					double *ci = &c(i, 0);
+					for(unsigned int j = 0; j < n; j++)
+						ci[j] += aik * bk[j];
+				}
+				else {
+					for(unsigned int j = 0; j < n; j++)
+						c(i, j) += aik * b(k, j);
 				}
 			}
-		}	
-		return result;
+		}
 	}
 
-	void Matrix::operator*= (Matrix &m1) {(*this) = (*this) * m1;}
+	Arena::Arena(std::size_t initialBytes) 
+		: current(0), offset(0), used(0), peak(0), blockSize(std::max<std::size_t>(initialBytes, 64)) {}
 
-	//  Soma os elementos de duas matrizes (M[i][j]+N[i][j] e retorna a matriz resultante.
-	Matrix Matrix::operator+ (Matrix &m1) {
-		if(this->getRowNumber() != m1.getRowNumber() or this->getColNumber() != m1.getColNumber())
-			throw std::string("Matrizes incompativeis.");
+	Arena::~Arena() {
+		for(const Block &b : blocks)
+			::operator delete(b.data, std::align_val_t(64));
+	}
+
+	void Arena::grow(std::size_t bytes) {
+		const std::size_t size = std::max(blockSize, bytes);
+		blocks.push_back(Block{static_cast<unsigned char*>(::operator new(size, std::align_val_t(64))), size});
+		current = blocks.size() - 1;
+		offset = 0;
+		blockSize *= 2;
+	}
+
+	//  Procura espaço no bloco em uso e nos seguintes (que sobraram de ciclos anteriores); 
+	//só reserva um bloco novo se nenhum deles comportar a alocação.
+	void *Arena::allocate(std::size_t bytes, std::size_t align) {
+		if(bytes == 0)
+			bytes = 1;
+
+		while(current < blocks.size()) {
+			const Block &b = blocks[current];
+			const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(b.data);
+			const std::uintptr_t start = (base + offset + align - 1) & ~std::uintptr_t(align - 1);
+			const std::size_t end = (start - base) + bytes;
+			if(end <= b.size) {
+				used += end - offset;
+				peak = std::max(peak, used);
+				offset = end;
+				return b.data + (start - base);
+			}
+			current++;
+			offset = 0;
+		}
 
-		Matrix helper = (*this);
+		grow(bytes + align);
+		return allocate(bytes, align);
+	}
 
-		for(unsigned int i = 0; i < helper.getRowNumber(); i++)
-			for(unsigned int j = 0; j < helper.getColNumber(); j++)
-				helper[i][j] += m1[i][j];
+	//  Se o ciclo precisou de mais de um bloco, os blocos são trocados por um único com o
+	//tamanho somado, para que o próximo ciclo não precise de novas reservas.
+	void Arena::reset() {
+		if(blocks.size() > 1) {
+			std::size_t total = 0;
+			for(const Block &b : blocks) {
+				total += b.size;
+				::operator delete(b.data, std::align_val_t(64));
+			}
+			blocks.clear();
+			blocks.push_back(Block{static_cast<unsigned char*>(::operator new(total, std::align_val_t(64))), total});
+		}
+		current = 0;
+		offset = 0;
+		used = 0;
+	}
 
-		return helper;
+	std::size_t Arena::getCapacity() const {
+		std::size_t total = 0;
+		for(const Block &b : blocks)
+			total += b.size;
+		return total;
 	}
 
-	void Matrix::operator+= (Matrix &m1) { (*this) = (*this) + m1; }
+	std::size_t Arena::getUsed() const { return used; }
+	std::size_t Arena::getPeak() const { return peak; }
 
-	Matrix Matrix::operator- (Matrix &m1) {
-		if(this->getRowNumber() != m1.getRowNumber() or this->getColNumber() != m1.getColNumber())
-			throw std::string("Matrizes incompativeis.");
+	static thread_local Arena *activeArena = nullptr;
 
-		Matrix helper = (*this);
+	Arena *currentArena() { return activeArena; }
 
-		for(unsigned int i = 0; i < helper.getRowNumber(); i++)
-			for(unsigned int j = 0; j < helper.getColNumber(); j++)
-				helper[i][j] -= m1[i][j];
+	ArenaScope::ArenaScope(Arena &a) : previous(activeArena) { activeArena = &a; }
 
-		return helper;
-	}
+	ArenaScope::~ArenaScope() { activeArena = previous; }
 
-	void Matrix::operator-= (Matrix &m1) { (*this) = (*this) - m1; }
 
-	//  Copia os membros da matriz do RHS pra matriz do LHS.
-	void Matrix::operator= (const Matrix &m1) { 
+	Matrix::Matrix(Matrix &&m1) noexcept 
+		: realMatrix(std::move(m1.realMatrix)), rowNumber(m1.rowNumber), colNumber(m1.colNumber) {
+		m1.realMatrix.clear();
+		m1.rowNumber = 0;
+		m1.colNumber = 0;
+	}
+
+	//  Copia os membros da matriz do RHS pra matriz do LHS. O vector reaproveita o buffer
+	//se a capacidade bastar.
+	Matrix &Matrix::operator= (const Matrix &m1) { 
 		this->realMatrix = m1.realMatrix; 
 		this->rowNumber = m1.rowNumber;
 		this->colNumber = m1.colNumber;
+		return *this;
+	}
+
+	//  Com arenas diferentes o vector copia os elementos para a memória do destino, por isso
+	//a troca de buffers não é usada aqui.
+	Matrix &Matrix::operator= (Matrix &&m1) {
+		realMatrix = std::move(m1.realMatrix);
+		rowNumber = m1.rowNumber;
+		colNumber = m1.colNumber;
+		m1.realMatrix.clear();
+		m1.rowNumber = 0;
+		m1.colNumber = 0;
+		return *this;
+	}
+
+	void Matrix::resize(unsigned int r, unsigned int c) {
+		realMatrix.assign(std::size_t(r) * c, 0.0);
+		rowNumber = r;
+		colNumber = c;
+	}
+
+
+	//  Os buffers são persistentes e nunca vêm de uma arena, mesmo se o Workspace for criado
+	//dentro de um ArenaScope.
+	Workspace::Workspace() {
+		buffers.reserve(WORKSPACE_SLOTS);
+		for(unsigned int i = 0; i < WORKSPACE_SLOTS; i++)
+			buffers.emplace_back(AlignedAllocator<unsigned char>(nullptr));
+	}
+
+	void *Workspace::reserve(workspaceSlot slot, std::size_t bytes) {
+		std::vector<unsigned char, AlignedAllocator<unsigned char>> &b = buffers[slot];
+		if(b.size() < bytes)
+			b.resize(bytes);
+		return b.data();
+	}
+
+	std::size_t Workspace::getBytes() const {
+		std::size_t total = 0;
+		for(const std::vector<unsigned char, AlignedAllocator<unsigned char>> &b : buffers)
+			total += b.capacity();
+		return total;
+	}
+
+	void Workspace::release() {
+		for(std::vector<unsigned char, AlignedAllocator<unsigned char>> &b : buffers) {
+			b.clear();
+			b.shrink_to_fit();
+		}
 	}
 
-	//  Retorna uma REFERÊNCIA ao vector<double> na posição [i], que pode ser
-	//acessado novamente com um [] (simulando uma matriz) e pode ser modificado.
-	std::vector<double> &Matrix::operator[] (unsigned int index) {
+	//  Retorna uma visão da linha [i], que pode ser acessada novamente com um [] 
+	//(simulando uma matriz) e cujos elementos podem ser modificados.
+	VectorView Matrix::operator[] (unsigned int index) {
 		if(index >= rowNumber)
 			throw "Acesso invalido";
 
-		return realMatrix[index]; 
+		return VectorView(data() + std::size_t(index) * colNumber, colNumber, 1); 
 	}
 
-	Matrix Matrix::operator-() {
-		Matrix temp(this->getRowNumber(), this->getColNumber());
-		for(unsigned int i = 0; i < getRowNumber(); i++){
-			for(unsigned int j = 0; j < getColNumber(); j++)
-				temp[i][j]= - realMatrix[i][j];
-		}
-		return temp;
+	ConstVectorView Matrix::operator[] (unsigned int index) const {
+		if(index >= rowNumber)
+			throw "Acesso invalido";
+
+		return ConstVectorView(data() + std::size_t(index) * colNumber, colNumber, 1); 
 	}
 
-	Matrix Matrix::transpose() {
-		Matrix temp(this->colNumber, this->rowNumber);
+	double &Matrix::at(unsigned int i, unsigned int j) {
+		if(i >= rowNumber or j >= colNumber)
+			throw std::string("Acesso invalido");
 
-		for(unsigned int i = 0; i < (this->rowNumber); i++){
-			for(unsigned int j = 0; j < (this->colNumber); j++)
-				temp[j][i] = this->realMatrix[i][j];
-		}
-		return temp;
+		return (*this)(i, j);
 	}
 
-	Matrix Matrix::Abs(){
-		Matrix temp(this->rowNumber, this->colNumber);
+	const double &Matrix::at(unsigned int i, unsigned int j) const {
+		if(i >= rowNumber or j >= colNumber)
+			throw std::string("Acesso invalido");
 
-		for(unsigned int i = 0; i < getRowNumber(); i++){
-			for(unsigned int j = 0; j < getColNumber(); j++)
-				if(realMatrix[i][j] < 0)
-                    temp[i][j] = -realMatrix[i][j];
-		}
-		return temp;
+		return (*this)(i, j);
+	}
+
+	VectorView Matrix::getCol(unsigned int col) {
+		if(colNumber <= col)
+			throw "Acesso invalido";
+
+		return VectorView(data() + col, rowNumber, colNumber);
 	}
 
-	std::vector<double> Matrix::getCol(unsigned int col) {
+	ConstVectorView Matrix::getCol(unsigned int col) const {
 		if(colNumber <= col)
 			throw "Acesso invalido";
 
-		std::vector<double> temp;
+		return ConstVectorView(data() + col, rowNumber, colNumber);
+	}
 
-		for(unsigned int i = 0; i < getRowNumber(); i++)
-			temp.push_back(realMatrix[i][col]);
+	bool Matrix::isSymmetric(double tol) const {
+		if(rowNumber != colNumber)
+			return false;
 
-		return temp;
+		for(unsigned int i = 0; i < rowNumber; i++) {
+			for(unsigned int j = 0; j < i; j++) {
+				const double a = (*this)(i, j), b = (*this)(j, i);
+				if(std::fabs(a - b) > tol * std::max(std::fabs(a), std::fabs(b)))
+					return false;
+			}
+		}
+		return true;
 	}
 
 	//  Getters dos membros de linha e coluna.
 	unsigned int Matrix::getColNumber() const { return colNumber; }
 	unsigned int Matrix::getRowNumber() const { return rowNumber; }
 
-	void Matrix::swapLines(double l1, double l2) {		
+	//  Troca as duas linhas diretamente no buffer, elemento a elemento.
+	void Matrix::swapLines(unsigned int l1, unsigned int l2) {		
 		if(this->getRowNumber() <= l1 or this->getRowNumber() <= l2)
 			throw "Acesso invalido.";
-		
-		std::vector<double> aux = (*this)[l1];
-		(*this)[l1] =  (*this)[l2];
-		(*this)[l2] = aux;
+
+		if(l1 == l2)
+			return;
+
+		double *r1 = data() + std::size_t(l1) * colNumber;
+		double *r2 = data() + std::size_t(l2) * colNumber;
+		std::swap_ranges(r1, r1 + colNumber, r2);
 	}
 
    
-	//  Construtor inicializa A e B com a e b, respectivamente. Além de fazer o vetor x receber o vetor
-	//nulo como chute inicial (acho que é uma escolha sensata).
-	EquationSystem::EquationSystem(Matrix a, Matrix b) : A(a), B(b), x(Matrix(b.getRowNumber())){
-		if(a.getRowNumber() != b.getRowNumber() or b.getColNumber() != 1)
-			throw "Matrizes incompatíveis";
+	SparseMatrix::SparseMatrix() : rowNumber(0), colNumber(0), rowPtr(1, 0) {}
+
+	SparseMatrix::SparseMatrix(unsigned int r, unsigned int c) : rowNumber(r), colNumber(c), rowPtr(r + 1, 0) {}
+
+	//  Montagem por contagem: as entradas são distribuídas por linha, ordenadas por 
+	//coluna dentro de cada linha e as repetidas são somadas.
+	SparseMatrix::SparseMatrix(unsigned int r, unsigned int c, const std::vector<Triplet> &t) : SparseMatrix(r, c, t.data(), t.size()) {}
+
+	SparseMatrix::SparseMatrix(unsigned int r, unsigned int c, const Triplet *t, std::size_t n) : SparseMatrix(r, c) {
+		IndexVector count(r + 1, 0);
+		for(std::size_t k = 0; k < n; k++) {
+			if(t[k].row >= r or t[k].col >= c)
+				throw std::string("Acesso invalido");
+			count[t[k].row + 1]++;
+		}
+		for(unsigned int i = 0; i < r; i++)
+			count[i + 1] += count[i];
+
+		IndexVector cols(n);
+		std::vector<double, AlignedAllocator<double>> vals(n);
+		IndexVector next(count.begin(), count.end() - 1);
+		for(std::size_t k = 0; k < n; k++) {
+			const unsigned int pos = next[t[k].row]++;
+			cols[pos] = t[k].col;
+			vals[pos] = t[k].value;
+		}
+
+		//  Ordena cada linha por coluna e junta as entradas repetidas.
+		IndexVector order;
+		colIndex.reserve(n);
+		values.reserve(n);
+		for(unsigned int i = 0; i < r; i++) {
+			order.resize(count[i + 1] - count[i]);
+			for(unsigned int k = 0; k < order.size(); k++)
+				order[k] = count[i] + k;
+			std::sort(order.begin(), order.end(), [&cols](unsigned int a, unsigned int b) { return cols[a] < cols[b]; });
+
+			for(unsigned int k = 0; k < order.size(); k++) {
+				if(colIndex.size() > rowPtr[i] and colIndex.back() == cols[order[k]])
+					values.back() += vals[order[k]];
+				else {
+					colIndex.push_back(cols[order[k]]);
+					values.push_back(vals[order[k]]);
+				}
+			}
+			rowPtr[i + 1] = colIndex.size();
+		}
 	}
- 
-	void EquationSystem::gaussSeidel(double tol, unsigned int maxIter) {
-		//  Cria um vetor para representar o x_k
-		Matrix x_k = x;	
-		
-		for(unsigned int k = 0; k < maxIter; k++) {
-			for(unsigned int i = 0; i < x.getRowNumber(); i++) {	
-				//  Variaveis para o somatorio.
-				double s1 = 0, s2 = 0;
-				//  Somatorio de a(i, j) * x_kMaisUm(j) de j=0 a i-1
-				for(unsigned int j = 0; j < i; j++) {
-					s1 += A[i][j] * x[j][0];
+
+	SparseMatrix::SparseMatrix(const Matrix &m, double tol) : SparseMatrix(m.getRowNumber(), m.getColNumber()) {
+		for(unsigned int i = 0; i < rowNumber; i++) {
+			for(unsigned int j = 0; j < colNumber; j++) {
+				if(std::fabs(m(i, j)) > tol) {
+					colIndex.push_back(j);
+					values.push_back(m(i, j));
 				}
-				//  Somatório de a(i, j) * x_k(j) de j=i+1 a n-1
-				for(unsigned int j = i+1; j < x.getRowNumber(); j++) {
-					s2 += A[i][j] * x_k[j][0];
+			}
+			rowPtr[i + 1] = colIndex.size();
+		}
+	}
+
+	SparseMatrix SparseMatrix::diagonal(const std::vector<double> &d) {
+		SparseMatrix temp(d.size(), d.size());
+		temp.colIndex.resize(d.size());
+		temp.values.assign(d.begin(), d.end());
+		for(unsigned int i = 0; i < d.size(); i++) {
+			temp.colIndex[i] = i;
+			temp.rowPtr[i + 1] = i + 1;
+		}
+		return temp;
+	}
+
+	Matrix SparseMatrix::toDense() const {
+		Matrix temp(rowNumber, colNumber);
+		for(unsigned int i = 0; i < rowNumber; i++)
+			for(unsigned int k = rowPtr[i]; k < rowPtr[i + 1]; k++)
+				temp(i, colIndex[k]) = values[k];
+		return temp;
+	}
+
+	//  Transposição por contagem das colunas; as linhas da transposta já saem ordenadas.
+	SparseMatrix SparseMatrix::transpose() const {
+		SparseMatrix temp(colNumber, rowNumber);
+		temp.colIndex.resize(getNonZeros());
+		temp.values.resize(getNonZeros());
+
+		for(unsigned int k = 0; k < getNonZeros(); k++)
+			temp.rowPtr[colIndex[k] + 1]++;
+		for(unsigned int j = 0; j < colNumber; j++)
+			temp.rowPtr[j + 1] += temp.rowPtr[j];
+
+		IndexVector next(temp.rowPtr.begin(), temp.rowPtr.end() - 1);
+		for(unsigned int i = 0; i < rowNumber; i++) {
+			for(unsigned int k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+				const unsigned int pos = next[colIndex[k]]++;
+				temp.colIndex[pos] = i;
+				temp.values[pos] = values[k];
+			}
+		}
+		return temp;
+	}
+
+	//  Produto de Gustavson: cada linha do resultado é acumulada em um vetor denso,
+	//e um marcador por coluna indica quais posições já pertencem à linha atual.
+	SparseMatrix SparseMatrix::operator* (const SparseMatrix &m1) const {
+		if(colNumber != m1.rowNumber)
+			throw std::string("Matrizes incompativeis.");
+
+		SparseMatrix result(rowNumber, m1.colNumber);
+		std::vector<double, AlignedAllocator<double>> acc(m1.colNumber, 0);
+		IndexVector marker(m1.colNumber, rowNumber);
+		IndexVector pattern;
+
+		for(unsigned int i = 0; i < rowNumber; i++) {
+			pattern.clear();
+			for(unsigned int k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+				const unsigned int row = colIndex[k];
+				const double a = values[k];
+				for(unsigned int l = m1.rowPtr[row]; l < m1.rowPtr[row + 1]; l++) {
+					const unsigned int j = m1.colIndex[l];
+					if(marker[j] != i) {
+						marker[j] = i;
+						acc[j] = 0;
+						pattern.push_back(j);
+					}
+					acc[j] += a * m1.values[l];
 				}
-				//  Atualiza o x_k+1 na posição i pela formula xi = 1/aii(bi-soma1-soma2)
-				x[i][0] = (B[i][0] - s1 - s2) / A[i][i];
-			}	
-			//  Criterio de parada. Se o maior elemento do módulo das diferenças entre x_k e
-			//x_k+1 for menor que a tolerância, o algoritmo para.
-			Matrix tolAux = x_k - x;
-			double biggest = fabs(tolAux[0][0]);
-			for(unsigned int i = 0; i < tolAux.getRowNumber(); i++) 
-				if(fabs(tolAux[i][0]) > biggest)
-					biggest = fabs(tolAux[i][0]);
-			if (biggest < tol)
-				break;
-			
-			//  Atualiza o x_k pro antigo x_k+1
-			x_k = x; 
-		}
-	}
-
-	//  Critério de convergência para o método de Gauss-Seidel.
-	bool EquationSystem::sassenfeldCriteria() {
-		//  Primeiro, é criado um vetor de N casas.
-		std::vector<double> beta_i(A.getRowNumber(), 0);
-		
-		//  A primeira casa é inicializada separadamente para garantir o funcionamento do laço.
-		for(unsigned int j = 1; j < A.getColNumber(); j++)
-			beta_i[0] += fabs(A[0][j]); 
-		beta_i[0] /= fabs(A[0][0]);
-
-		for(unsigned int i = 1; i < A.getRowNumber(); i++) {
-			for(unsigned int j = 0; j < i - 1; j++)
-				beta_i[i] += beta_i[j]*fabs(A[i][j]);
-			for(unsigned int j = i + 1; j < A.getColNumber(); j++)
-				beta_i[i] += fabs(A[i][j]);
-			beta_i[i] /= A[i][i]; 
-		}
-		
-		//  O critério de Sassenfeld diz que o sistema converge se o maior elemento do vetor 
-		//beta for menor que 1. A função retorna se o critério é satisfeito.
-		return ( *max_element(beta_i.begin(), beta_i.end()) < 1 )? 1 : 0;
-	}
-
-
-	void EquationSystem::findPivot (unsigned int startI) {	
-
-		unsigned int index = startI;	
-		
-		//  Busca linear p/ achar o maior elemento.
-		double biggest = A[startI][startI];
-		for(unsigned int i = startI; i < A.getRowNumber(); i++) {	
-			if(fabs(A[i][startI]) > fabs(biggest)) {
-				biggest = A[i][startI];
-				index = i;
-			}
-		}
-		//  Troca as linhas do maior elemento com o atual.
-		A.swapLines(startI, index);	
-		B.swapLines(startI, index);
-	}
-
-	void EquationSystem::gaussJordan() {
-		//  Matrizes auxiliares para não alterar as matrizes do sistema.
-		Matrix a = A;
-		Matrix b = B;
-	
-		for(unsigned int i = 0; i < a.getRowNumber() and i < a.getColNumber(); i++) {
-			//  Coloca na diagonal principal o maior elemento da coluna.
-			this->findPivot(i);
-			
-			//  Escolhe o elemento da diagonal principal como pivô.
-			double div = a[i][i];
-
-			if(div == 0)
+			}
+			std::sort(pattern.begin(), pattern.end());
+			for(unsigned int k = 0; k < pattern.size(); k++) {
+				result.colIndex.push_back(pattern[k]);
+				result.values.push_back(acc[pattern[k]]);
+			}
+			result.rowPtr[i + 1] = result.colIndex.size();
+		}
+		return result;
+	}
+
+	Matrix SparseMatrix::operator* (const Matrix &m1) const {
+		if(colNumber != m1.getRowNumber())
+			throw std::string("Matrizes incompativeis.");
+
+		const unsigned int m = m1.getColNumber();
+		Matrix result(rowNumber, m);
+
+		if(m == 1) {
+			multiply(m1.data(), result.data());
+			return result;
+		}
+
+		//  Cada entrada (i, k) acumula a linha k de m1 na linha i do resultado.
+		for(unsigned int i = 0; i < rowNumber; i++) {
+			double *r = &result(i, 0);
+			for(unsigned int k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+				const double a = values[k];
+				const double *b = &m1(colIndex[k], 0);
+				for(unsigned int j = 0; j < m; j++)
+					r[j] += a * b[j];
+			}
+		}
+		return result;
+	}
+
+	//  Kernel SpMV. Quatro acumuladores independentes quebram a dependência entre as
+	//somas, permitindo que o compilador vetorize e sobreponha as multiplicações.
+	void SparseMatrix::multiply(const double *x, double *y) const {
+		const unsigned int *__restrict rp = rowPtr.data();
+		const unsigned int *__restrict ci = colIndex.data();
+		const double *__restrict v = values.data();
+
+		for(unsigned int i = 0; i < rowNumber; i++) {
+			unsigned int k = rp[i];
+			const unsigned int end = rp[i + 1];
+			double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+
+			for(; k + 4 <= end; k += 4) {
+				s0 += v[k] * x[ci[k]];
+				s1 += v[k + 1] * x[ci[k + 1]];
+				s2 += v[k + 2] * x[ci[k + 2]];
+				s3 += v[k + 3] * x[ci[k + 3]];
+			}
+			for(; k < end; k++)
+				s0 += v[k] * x[ci[k]];
+
+			y[i] = (s0 + s1) + (s2 + s3);
+		}
+	}
+
+	double SparseMatrix::get(unsigned int i, unsigned int j) const {
+		if(i >= rowNumber or j >= colNumber)
+			throw std::string("Acesso invalido");
+
+		const unsigned int *begin = colIndex.data() + rowPtr[i];
+		const unsigned int *end = colIndex.data() + rowPtr[i + 1];
+		const unsigned int *it = std::lower_bound(begin, end, j);
+
+		return (it != end and *it == j) ? values[it - colIndex.data()] : 0;
+	}
+
+	bool SparseMatrix::isSymmetric(double tol) const {
+		if(rowNumber != colNumber)
+			return false;
+
+		for(unsigned int i = 0; i < rowNumber; i++) {
+			for(unsigned int k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+				const double a = values[k], b = get(colIndex[k], i);
+				if(std::fabs(a - b) > tol * std::max(std::fabs(a), std::fabs(b)))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	unsigned int SparseMatrix::getRowNumber() const { return rowNumber; }
+	unsigned int SparseMatrix::getColNumber() const { return colNumber; }
+	unsigned int SparseMatrix::getNonZeros() const { return colIndex.size(); }
+	const IndexVector &SparseMatrix::getRowPtr() const { return rowPtr; }
+	const IndexVector &SparseMatrix::getColIndex() const { return colIndex; }
+	const double *SparseMatrix::getValues() const { return values.data(); }
+	double *SparseMatrix::getValues() { return values.data(); }
+
+	LUDecomposition::LUDecomposition() : LU(0, 0), factored(false), singular(false) {}
+
+	LUDecomposition::LUDecomposition(const Matrix &a) : LUDecomposition() { factorize(a); }
+
+	void LUDecomposition::factorize(const Matrix &a) {
+		if(a.getRowNumber() != a.getColNumber())
+			throw std::string("Matriz nao quadrada");
+
+		const unsigned int n = a.getRowNumber();
+		LU = a;
+		pivots.resize(n);
+		singular = not getBackend().getrf(n, LU.data(), n, pivots.data());
+
+		//  Reconstrói a permutação final a partir da sequência de trocas.
+		perm.resize(n);
+		for(unsigned int i = 0; i < n; i++)
+			perm[i] = i;
+		for(unsigned int k = 0; k < n; k++)
+			std::swap(perm[k], perm[pivots[k] - 1]);
+		factored = true;
+	}
+
+	//  Eliminação de Gauss à direita (right-looking). Os multiplicadores de L ficam 
+	//guardados nas posições zeradas de cada linha, e as linhas inteiras são trocadas.
+	bool LUDecomposition::factorizeInPlace(MatrixView a, std::vector<unsigned int> &perm) {
+		const unsigned int n = a.getRowNumber();
+		bool regular = true;
+
+		perm.resize(n);
+		for(unsigned int i = 0; i < n; i++)
+			perm[i] = i;
+
+		for(unsigned int k = 0; k < n; k++) {
+			//  Busca linear p/ achar o maior elemento da coluna k entre as linhas restantes.
+			unsigned int index = k;
+			double biggest = std::fabs(a(k, k));
+			for(unsigned int i = k + 1; i < n; i++) {
+				if(std::fabs(a(i, k)) > biggest) {
+					biggest = std::fabs(a(i, k));
+					index = i;
+				}
+			}
+
+			//  Coluna nula: não há pivô, a incógnita k é deixada de lado.
+			if(biggest == 0) {
+				regular = false;
 				continue;
+			}
 
-			//  Pivoteia a linha do pivô (L_i <- 1/pivô * L_i).
-			for(unsigned int j = i; j < a.getColNumber(); j++) { a[i][j] /= div; }
-			//  Faz a mesma operação no vetor B, como na matriz expandida.
-			b[i][0] /= div;		
-			
-			//  Zera os elementos acima e abaixo do pivô.
-			for(unsigned int k = 0; k < a.getRowNumber(); k++) {
-				if(i == k)
+			if(index != k) {
+				for(unsigned int c = 0; c < n; c++)
+					std::swap(a(k, c), a(index, c));
+				std::swap(perm[k], perm[index]);
+			}
+
+			const double *pivotRow = &a(k, 0);
+			const std::ptrdiff_t cs = a.getColStride();
+			const double pivot = pivotRow[k * cs];
+
+			for(unsigned int i = k + 1; i < n; i++) {
+				double *row = &a(i, 0);
+				const double mult = row[k * cs] / pivot;
+				row[k * cs] = mult;
+
+				if(mult == 0)
 					continue;
 
-				double mult = a[k][i];
-				//  Realiza as operações na linha. L_k <- -mult*L_i.
-				//Isso zera os elementos na coluna do pivô.
-				for(unsigned int l = i; l < a.getColNumber(); l++) {
-					a[k][l] -= mult * a[i][l];
+				//  L_i <- L_i - mult*L_k, apenas na parte ativa da linha.
+				for(unsigned int j = k + 1; j < n; j++)
+					row[j * cs] -= mult * pivotRow[j * cs];
+			}
+		}
+		return regular;
+	}
+
+	//  Largura dos painéis e dos blocos de atualização das fatorações blocadas. Os blocos
+	//não dependem do número de threads: cada um é sempre calculado pela mesma sequência
+	//de operações, e o resultado é reprodutível bit a bit.
+	static const unsigned int panelWidth = 64;
+	static const unsigned int updateTile = 256;
+
+	//  Troca duas linhas inteiras de uma visão.
+	template <typename T>
+	static void swapRows(const BasicMatrixView<T> &a, unsigned int i, unsigned int j) {
+		for(unsigned int c = 0; c < a.getColNumber(); c++)
+			std::swap(a(i, c), a(j, c));
+	}
+
+	//  c -= a*b, com a multiplicação de cada precisão.
+	static void subtractProduct(const ConstMatrixView &a, const ConstMatrixView &b, const MatrixView &c) {
+		multiplyAdd(a, b, c, -1);
+	}
+
+	static void subtractProduct(const ConstFloatMatrixView &a, const ConstFloatMatrixView &b, const FloatMatrixView &c) {
+		gemm(a, b, c, -1.0f);
+	}
+
+	//  Fatora o painel de colunas [k0, k1), nas linhas k0 a n - 1. Painéis largos são
+	//divididos ao meio: a metade esquerda é fatorada, a direita recebe U12 = L11^-1*A12 e
+	//A22 -= L21*U12 (um produto de matrizes) e então é fatorada. As trocas de linhas são
+	//aplicadas às linhas inteiras da matriz.
+	template <typename T>
+	static bool panelLU(const BasicMatrixView<T> &a, std::vector<unsigned int> &perm, unsigned int k0, unsigned int k1) {
+		const unsigned int n = a.getRowNumber();
+
+		if(k1 - k0 > 16) {
+			const unsigned int km = k0 + (k1 - k0) / 2;
+			bool regular = panelLU(a, perm, k0, km);
+
+			for(unsigned int k = k0; k < km; k++)
+				for(unsigned int i = k + 1; i < km; i++) {
+					const T mult = a(i, k);
+					if(mult == 0)
+						continue;
+					for(unsigned int j = km; j < k1; j++)
+						a(i, j) -= mult * a(k, j);
+				}
+			subtractProduct(a.block(km, k0, n - km, km - k0), a.block(k0, km, km - k0, k1 - km), a.block(km, km, n - km, k1 - km));
+
+			regular = panelLU(a, perm, km, k1) and regular;
+			return regular;
+		}
+
+		bool regular = true;
+		for(unsigned int k = k0; k < k1; k++) {
+			unsigned int index = k;
+			T biggest = std::fabs(a(k, k));
+			for(unsigned int i = k + 1; i < n; i++) {
+				if(std::fabs(a(i, k)) > biggest) {
+					biggest = std::fabs(a(i, k));
+					index = i;
 				}
-				//  Novamente, a operação é realizada no vetor B, como
-				//na matriz expandida.
-				b[k][0] -= mult * b[i][0];  	
+			}
+
+			if(biggest == 0) {
+				regular = false;
+				continue;
+			}
+
+			if(index != k) {
+				swapRows(a, k, index);
+				std::swap(perm[k], perm[index]);
+			}
+
+			const T pivot = a(k, k);
+			for(unsigned int i = k + 1; i < n; i++) {
+				const T mult = a(i, k) / pivot;
+				a(i, k) = mult;
+				if(mult == 0)
+					continue;
+				for(unsigned int j = k + 1; j < k1; j++)
+					a(i, j) -= mult * a(k, j);
 			}
 		}
-		//  Passa o vetor b da matriz expandida (resultado) para o vetor x.
-		x = b;
+		return regular;
 	}
-	//  Função que resolve o sistema linear.
-	Matrix EquationSystem::getSolution( double tol,  unsigned int maxIter){
-		//  Se o método de Gauß-Seidel converge para o sistema, ele é chamado.
-		if(sassenfeldCriteria() and A.getRowNumber() == A.getColNumber())
-			gaussSeidel(tol, maxIter);
-		//  Senão, é chamado um método direto.
+
+	//  Versão blocada (à direita) da eliminação. Depois de cada painel de colunas [k0, k1),
+	//cada bloco de colunas à direita recebe U12 = L11^-1*A12 e A22 -= L21*U12 em uma tarefa
+	//independente. Aqui as linhas são trocadas fisicamente, para que L21 e U12 sejam visões
+	//contíguas: a linha k termina com os fatores da linha original perm[k].
+	template <typename T>
+	static bool blockedLU(const BasicMatrixView<T> &a, std::vector<unsigned int> &perm) {
+		const unsigned int n = a.getRowNumber();
+		if(n != a.getColNumber())
+			throw std::string("Matriz nao quadrada");
+
+		bool regular = true;
+		ThreadPool &pool = getThreadPool();
+
+		perm.resize(n);
+		for(unsigned int i = 0; i < n; i++)
+			perm[i] = i;
+
+		for(unsigned int k0 = 0; k0 < n; k0 += panelWidth) {
+			const unsigned int k1 = std::min(n, k0 + panelWidth);
+			regular = panelLU(a, perm, k0, k1) and regular;
+
+			if(k1 == n)
+				break;
+
+			const unsigned int rest = n - k1;
+			const unsigned int tiles = (rest + updateTile - 1) / updateTile;
+
+			pool.parallelFor(tiles, [&](unsigned int t) {
+				const unsigned int c0 = k1 + t * updateTile;
+				const unsigned int cb = std::min(updateTile, n - c0);
+
+				//  U12 = L11^-1*A12, por substituição direta nas linhas do painel.
+				for(unsigned int k = k0; k < k1; k++)
+					for(unsigned int i = k + 1; i < k1; i++) {
+						const T mult = a(i, k);
+						if(mult == 0)
+							continue;
+						for(unsigned int j = c0; j < c0 + cb; j++)
+							a(i, j) -= mult * a(k, j);
+					}
+
+				subtractProduct(a.block(k1, k0, rest, k1 - k0), a.block(k0, c0, k1 - k0, cb), a.block(k1, c0, rest, cb));
+			});
+		}
+		return regular;
+	}
+
+	bool LUDecomposition::factorizeBlocked(MatrixView a, std::vector<unsigned int> &perm) {
+		return blockedLU(a, perm);
+	}
+
+	void LUDecomposition::solve(Matrix &b) const {
+		const Matrix rhs(b);
+		solve(rhs, b);
+	}
+
+	//  As substituições são feitas diretamente em y, sem matrizes intermediárias. Matrizes
+	//singulares usam sempre o backend embutido, que leva a zero as incógnitas sem pivô.
+	void LUDecomposition::solve(const Matrix &b, Matrix &y) const {
+		if(not factored)
+			throw std::string("Matriz nao fatorada");
+
+		const unsigned int n = LU.getRowNumber();
+		const unsigned int m = b.getColNumber();
+
+		if(b.getRowNumber() != n)
+			throw std::string("Matrizes incompativeis.");
+
+		y = b;
+		const Backend &backend = singular ? getBackend(BUILTIN_BACKEND) : getBackend();
+		backend.getrs(n, m, LU.data(), n, pivots.data(), y.data(), m);
+	}
+
+	bool LUDecomposition::isFactored() const { return factored; }
+	bool LUDecomposition::isSingular() const { return singular; }
+	const std::vector<unsigned int> &LUDecomposition::getPermutation() const { return perm; }
+
+
+	SinglePrecisionLU::SinglePrecisionLU() : size(0), factored(false), singular(false) {}
+
+	void SinglePrecisionLU::factorize(const Matrix &a) {
+		if(a.getRowNumber() != a.getColNumber())
+			throw std::string("Matriz nao quadrada");
+
+		size = a.getRowNumber();
+		LU.resize(std::size_t(size) * size);
+		for(unsigned int i = 0; i < size; i++)
+			for(unsigned int j = 0; j < size; j++)
+				LU[std::size_t(i) * size + j] = static_cast<float>(a(i, j));
+
+		singular = not blockedLU(FloatMatrixView(LU.data(), size, size, size, 1), perm);
+		factored = true;
+	}
+
+	//  As linhas do fator estão na ordem pivotada: a linha i corresponde à linha perm[i]
+	//da matriz original.
+	void SinglePrecisionLU::solve(Matrix &b) const {
+		if(not factored)
+			throw std::string("Matriz nao fatorada");
+
+		const unsigned int n = size;
+		const unsigned int m = b.getColNumber();
+
+		if(b.getRowNumber() != n)
+			throw std::string("Matrizes incompativeis.");
+
+		std::vector<float> y(std::size_t(n) * m);
+		for(unsigned int i = 0; i < n; i++)
+			for(unsigned int c = 0; c < m; c++)
+				y[std::size_t(i) * m + c] = static_cast<float>(b(perm[i], c));
+
+		for(unsigned int i = 0; i < n; i++) {
+			const float *row = &LU[std::size_t(i) * n];
+			float *yi = &y[std::size_t(i) * m];
+			for(unsigned int j = 0; j < i; j++) {
+				if(row[j] == 0)
+					continue;
+				for(unsigned int c = 0; c < m; c++)
+					yi[c] -= row[j] * y[std::size_t(j) * m + c];
+			}
+		}
+
+		for(unsigned int i = n; i-- > 0;) {
+			const float *row = &LU[std::size_t(i) * n];
+			float *yi = &y[std::size_t(i) * m];
+			if(row[i] == 0) {
+				for(unsigned int c = 0; c < m; c++)
+					yi[c] = 0;
+				continue;
+			}
+			for(unsigned int j = i + 1; j < n; j++) {
+				if(row[j] == 0)
+					continue;
+				for(unsigned int c = 0; c < m; c++)
+					yi[c] -= row[j] * y[std::size_t(j) * m + c];
+			}
+			for(unsigned int c = 0; c < m; c++)
+				yi[c] /= row[i];
+		}
+
+		for(unsigned int i = 0; i < n; i++)
+			for(unsigned int c = 0; c < m; c++)
+				b(i, c) = y[std::size_t(i) * m + c];
+	}
+
+	bool SinglePrecisionLU::isFactored() const { return factored; }
+	bool SinglePrecisionLU::isSingular() const { return singular; }
+
+   
+	CholeskyDecomposition::CholeskyDecomposition() : LD(0, 0), factored(false), squareRoot(false) {}
+
+	//  O backend embutido fatora diretamente em LDLt, que também aceita matrizes 
+	//semidefinidas; um backend externo tenta antes o potrf.
+	bool CholeskyDecomposition::factorize(const Matrix &a) {
+		if(a.getRowNumber() != a.getColNumber())
+			throw std::string("Matriz nao quadrada");
+
+		const unsigned int n = a.getRowNumber();
+		LD = a;
+		squareRoot = false;
+		if(getBackendType() != BUILTIN_BACKEND) {
+			if(getBackend().potrf(n, LD.data(), n)) {
+				squareRoot = true;
+				factored = true;
+				return factored;
+			}
+			LD = a;
+		}
+
+		if(n >= blockedThreshold)
+			factored = factorizeBlocked(LD.view());
 		else
-			gaussJordan();
-		
-		return x;
+			factored = factorizeInPlace(LD.view());
+		return factored;
+	}
+
+	//  Fatoração por linhas (Crout): a linha j de L é obtida a partir das linhas já 
+	//fatoradas, de modo que todos os produtos internos percorrem linhas contíguas.
+	bool CholeskyDecomposition::factorizeInPlace(MatrixView a) {
+		const unsigned int n = a.getRowNumber();
+		if(n != a.getColNumber())
+			throw std::string("Matriz nao quadrada");
+
+		//  Pivôs menores que tol são considerados nulos.
+		double maxDiag = 0;
+		for(unsigned int i = 0; i < n; i++)
+			maxDiag = std::max(maxDiag, std::fabs(a(i, i)));
+		const double tol = maxDiag * n * 1e-14;
+		const double offTol = maxDiag * 1e-8;
+
+		//  w[k] = L(j, k)*D(k), reaproveitado nos produtos internos da linha j.
+		std::vector<double> w(n);
+
+		for(unsigned int j = 0; j < n; j++) {
+			for(unsigned int k = 0; k < j; k++) {
+				double t = a(j, k);
+				for(unsigned int p = 0; p < k; p++)
+					t -= w[p] * a(k, p);
+
+				const double d = a(k, k);
+				if(d == 0) {
+					//  Pivô nulo: em uma matriz semidefinida a coluna também é nula.
+					if(std::fabs(t) > offTol)
+						return false;
+					w[k] = 0;
+					a(j, k) = 0;
+					continue;
+				}
+				w[k] = t;
+				a(j, k) = t / d;
+			}
+
+			double d = a(j, j);
+			for(unsigned int p = 0; p < j; p++)
+				d -= w[p] * a(j, p);
+
+			//  Pivô negativo: a matriz não é positiva semidefinida.
+			if(d < -tol)
+				return false;
+
+			a(j, j) = (d <= tol) ? 0 : d;
+		}
+		return true;
+	}
+
+	//  Versão blocada (à direita) da fatoração LDLt. O painel de colunas [k0, k1) é 
+	//fatorado por linhas, como em factorizeInPlace, da diagonal até a última linha; o 
+	//triângulo inferior restante recebe A22 -= (L21*D1)*L21t, dividido em blocos 
+	//quadrados calculados em paralelo.
+	bool CholeskyDecomposition::factorizeBlocked(MatrixView a) {
+		const unsigned int n = a.getRowNumber();
+		if(n != a.getColNumber())
+			throw std::string("Matriz nao quadrada");
+
+		double maxDiag = 0;
+		for(unsigned int i = 0; i < n; i++)
+			maxDiag = std::max(maxDiag, std::fabs(a(i, i)));
+		const double tol = maxDiag * n * 1e-14;
+		const double offTol = maxDiag * 1e-8;
+
+		ThreadPool &pool = getThreadPool();
+
+		//  Linha i - k1 de w guarda L(i, k)*D(k) para as colunas do painel, que formam o
+		//operando esquerdo da atualização.
+		Matrix w(n, panelWidth);
+
+		for(unsigned int k0 = 0; k0 < n; k0 += panelWidth) {
+			const unsigned int k1 = std::min(n, k0 + panelWidth);
+			const unsigned int kb = k1 - k0;
+
+			for(unsigned int j = k0; j < n; j++) {
+				double *wj = &w(j < k1 ? 0 : j - k1, 0);
+				const unsigned int kEnd = std::min(j, k1);
+
+				for(unsigned int k = k0; k < kEnd; k++) {
+					double t = a(j, k);
+					for(unsigned int p = k0; p < k; p++)
+						t -= wj[p - k0] * a(k, p);
+
+					const double d = a(k, k);
+					if(d == 0) {
+						if(std::fabs(t) > offTol)
+							return false;
+						wj[k - k0] = 0;
+						a(j, k) = 0;
+						continue;
+					}
+					wj[k - k0] = t;
+					a(j, k) = t / d;
+				}
+
+				if(j >= k1)
+					continue;
+
+				double d = a(j, j);
+				for(unsigned int p = k0; p < j; p++)
+					d -= wj[p - k0] * a(j, p);
+
+				if(d < -tol)
+					return false;
+
+				a(j, j) = (d <= tol) ? 0 : d;
+			}
+
+			if(k1 == n)
+				break;
+
+			const unsigned int rest = n - k1;
+
+			//  Blocos (I, J) com J <= I, numerados linha a linha.
+			const unsigned int tiles = (rest + updateTile - 1) / updateTile;
+			const ConstMatrixView W = w.view().block(0, 0, rest, kb);
+
+			pool.parallelFor(tiles * (tiles + 1) / 2, [&](unsigned int t) {
+				unsigned int I = 0;
+				while((I + 1) * (I + 2) / 2 <= t)
+					I++;
+				const unsigned int J = t - I * (I + 1) / 2;
+
+				const unsigned int r0 = I * updateTile, rb = std::min(updateTile, rest - r0);
+				const unsigned int c0 = J * updateTile, cb = std::min(updateTile, rest - c0);
+				const ConstMatrixView lt = ConstMatrixView(a).block(k1 + c0, k0, cb, kb).transpose();
+
+				if(I != J) {
+					multiplyAdd(W.block(r0, 0, rb, kb), lt, a.block(k1 + r0, k1 + c0, rb, cb), -1);
+					return;
+				}
+
+				//  Bloco diagonal: o triângulo superior da matriz não pode ser escrito.
+				Matrix diag(rb, cb);
+				multiplyAdd(W.block(r0, 0, rb, kb), lt, diag.view(), 1);
+				for(unsigned int i = 0; i < rb; i++)
+					for(unsigned int j = 0; j <= i; j++)
+						a(k1 + r0 + i, k1 + c0 + j) -= diag(i, j);
+			});
+		}
+		return true;
+	}
+
+	void CholeskyDecomposition::solve(Matrix &b) const {
+		if(not factored)
+			throw std::string("Matriz nao fatorada");
+
+		const unsigned int n = LD.getRowNumber();
+		const unsigned int m = b.getColNumber();
+
+		if(b.getRowNumber() != n)
+			throw std::string("Matrizes incompativeis.");
+
+		if(squareRoot) {
+			getBackend().potrs(n, m, LD.data(), n, b.data(), m);
+			return;
+		}
+
+		//  Substituição direta com L.
+		for(unsigned int i = 0; i < n; i++) {
+			const double *row = &LD(i, 0);
+			for(unsigned int j = 0; j < i; j++) {
+				if(row[j] == 0)
+					continue;
+				for(unsigned int c = 0; c < m; c++)
+					b(i, c) -= row[j] * b(j, c);
+			}
+		}
+
+		//  Divisão pela diagonal D. Pivôs nulos levam a incógnita a zero.
+		for(unsigned int i = 0; i < n; i++) {
+			const double d = LD(i, i);
+			for(unsigned int c = 0; c < m; c++)
+				b(i, c) = (d == 0) ? 0 : b(i, c) / d;
+		}
+
+		//  Substituição reversa com Lt, orientada por linhas de L: quando x(i) fica
+		//pronto, sua contribuição é removida das incógnitas anteriores.
+		for(unsigned int i = n; i-- > 0;) {
+			const double *row = &LD(i, 0);
+			for(unsigned int j = 0; j < i; j++) {
+				if(row[j] == 0)
+					continue;
+				for(unsigned int c = 0; c < m; c++)
+					b(j, c) -= row[j] * b(i, c);
+			}
+		}
+	}
+
+	//  Método C1 de Gill, Golub, Murray e Saunders para LDLt: a coluna j de L e o pivô
+	//D(j) absorvem a parte de v que resta após eliminar as colunas anteriores.
+	bool CholeskyDecomposition::update(std::vector<double> v, double alpha) {
+		if(v.size() != LD.getRowNumber())
+			throw std::string("Matrizes incompativeis.");
+
+		Workspace w;
+		return update(v.data(), alpha, w);
+	}
+
+	bool CholeskyDecomposition::update(const double *u, double alpha, Workspace &w) {
+		if(not factored)
+			throw std::string("Matriz nao fatorada");
+		if(squareRoot)
+			splitDiagonal();
+
+		const unsigned int n = LD.getRowNumber();
+		double *v = w.get<double>(UPDATE_SLOT, n);
+		std::copy(u, u + n, v);
+
+		for(unsigned int j = 0; j < n and alpha != 0; j++) {
+			const double p = v[j];
+			if(p == 0)
+				continue;
+
+			const double d = LD(j, j);
+			const double dNew = d + alpha * p * p;
+
+			//  Pivôs nulos e cancelamentos severos exigem uma nova fatoração.
+			if(d == 0 or dNew <= d * 1e-12) {
+				factored = false;
+				return false;
+			}
+
+			const double beta = p * alpha / dNew;
+			alpha *= d / dNew;
+			LD(j, j) = dNew;
+
+			for(unsigned int i = j + 1; i < n; i++) {
+				v[i] -= p * LD(i, j);
+				LD(i, j) += beta * v[i];
+			}
+		}
+		return true;
+	}
+
+	//  L*Lt = (L/diag(L))*diag(L)²*(L/diag(L))t.
+	void CholeskyDecomposition::splitDiagonal() {
+		const unsigned int n = LD.getRowNumber();
+		for(unsigned int j = 0; j < n; j++) {
+			const double s = LD(j, j);
+			for(unsigned int i = j + 1; i < n; i++)
+				LD(i, j) /= s;
+			LD(j, j) = s * s;
+		}
+		squareRoot = false;
+	}
+
+	bool CholeskyDecomposition::isFactored() const { return factored; }
+
+   
+	SparseCholesky::SparseCholesky() : size(0), patternHash(0), analyzed(false), factored(false) {}
+
+	unsigned long long SparseCholesky::hashPattern(const SparseMatrix &a) {
+		unsigned long long h = 14695981039346656037ULL;
+		const IndexVector &rp = a.getRowPtr();
+		const IndexVector &ci = a.getColIndex();
+
+		for(std::size_t k = 0; k < rp.size(); k++)
+			h = (h ^ rp[k]) * 1099511628211ULL;
+		for(std::size_t k = 0; k < ci.size(); k++)
+			h = (h ^ ci[k]) * 1099511628211ULL;
+		return h;
+	}
+
+	//  Grau mínimo sobre o grafo quociente. Cada nó é uma variável (ainda não eliminada)
+	//ou um elemento (variável eliminada, que representa a clique formada por seus vizinhos).
+	//O grau de uma variável é aproximado por |variáveis adjacentes| + |L_p| + soma de 
+	//|L_e \ L_p| para os demais elementos adjacentes, como no algoritmo AMD.
+	void SparseCholesky::minimumDegreeOrdering(const SparseMatrix &a, std::vector<unsigned int> &perm) {
+		const unsigned int n = a.getRowNumber();
+		if(n != a.getColNumber())
+			throw std::string("Matriz nao quadrada");
+
+		//  0: variável; 1: elemento; 2: elemento absorvido por outro.
+		std::vector<unsigned char> status(n, 0);
+		std::vector<std::vector<unsigned int>> vars(n), elems(n);
+		std::vector<unsigned int> degree(n), stamp(n, 0), wStamp(n, 0), w(n, 0);
+		unsigned int tag = 0;
+
+		//  Padrão de A + At sem a diagonal.
+		const SparseMatrix at = a.transpose();
+		const SparseMatrix *sides[2] = {&a, &at};
+		for(unsigned int i = 0; i < n; i++) {
+			tag++;
+			stamp[i] = tag;
+			for(unsigned int s = 0; s < 2; s++) {
+				const IndexVector &rp = sides[s]->getRowPtr();
+				const IndexVector &ci = sides[s]->getColIndex();
+				for(unsigned int k = rp[i]; k < rp[i + 1]; k++) {
+					if(stamp[ci[k]] != tag) {
+						stamp[ci[k]] = tag;
+						vars[i].push_back(ci[k]);
+					}
+				}
+			}
+			degree[i] = vars[i].size();
+		}
+
+		std::set<std::pair<unsigned int, unsigned int>> queue;
+		for(unsigned int i = 0; i < n; i++)
+			queue.insert(std::make_pair(degree[i], i));
+
+		perm.clear();
+		perm.reserve(n);
+		std::vector<unsigned int> Lpivot, kept;
+
+		for(unsigned int k = 0; k < n; k++) {
+			const unsigned int p = queue.begin()->second;
+			queue.erase(queue.begin());
+			perm.push_back(p);
+
+			//  L_p: variáveis adjacentes a p diretamente ou através de seus elementos,
+			//que são absorvidos pelo novo elemento p.
+			tag++;
+			stamp[p] = tag;
+			Lpivot.clear();
+			for(unsigned int v : vars[p]) {
+				if(status[v] == 0 and stamp[v] != tag) {
+					stamp[v] = tag;
+					Lpivot.push_back(v);
+				}
+			}
+			for(unsigned int e : elems[p]) {
+				if(status[e] != 1)
+					continue;
+				for(unsigned int v : vars[e]) {
+					if(status[v] == 0 and stamp[v] != tag) {
+						stamp[v] = tag;
+						Lpivot.push_back(v);
+					}
+				}
+				status[e] = 2;
+				std::vector<unsigned int>().swap(vars[e]);
+			}
+			status[p] = 1;
+			vars[p] = Lpivot;
+			std::vector<unsigned int>().swap(elems[p]);
+
+			//  w[e] = |L_e \ L_p| para os elementos vizinhos de L_p.
+			for(unsigned int i : Lpivot) {
+				for(unsigned int e : elems[i]) {
+					if(status[e] != 1 or wStamp[e] == tag)
+						continue;
+					wStamp[e] = tag;
+					unsigned int count = 0;
+					for(unsigned int v : vars[e])
+						if(status[v] == 0 and stamp[v] != tag)
+							count++;
+					w[e] = count;
+				}
+			}
+
+			//  Atualiza as listas e o grau aproximado de cada variável de L_p.
+			const unsigned int remaining = n - k - 1;
+			for(unsigned int i : Lpivot) {
+				queue.erase(std::make_pair(degree[i], i));
+
+				unsigned int d = Lpivot.size() - 1;
+
+				kept.clear();
+				for(unsigned int e : elems[i]) {
+					if(status[e] == 1) {
+						kept.push_back(e);
+						d += w[e];
+					}
+				}
+				kept.push_back(p);
+				elems[i].swap(kept);
+
+				//  Variáveis que também estão em L_p passam a ser alcançadas pelo elemento p.
+				kept.clear();
+				for(unsigned int v : vars[i])
+					if(status[v] == 0 and stamp[v] != tag)
+						kept.push_back(v);
+				vars[i].swap(kept);
+				d += vars[i].size();
+
+				degree[i] = std::min(d, remaining - 1);
+				queue.insert(std::make_pair(degree[i], i));
+			}
+		}
+	}
+
+	//  Análise simbólica: árvore de eliminação e contagem de entradas por coluna de L.
+	//A linha k de P*A*Pt é a linha perm[k] de A, com as colunas renumeradas por pinv.
+	void SparseCholesky::analyze(const SparseMatrix &a) {
+		const unsigned int n = a.getRowNumber();
+
+		minimumDegreeOrdering(a, perm);
+		pinv.assign(n, 0);
+		for(unsigned int k = 0; k < n; k++)
+			pinv[perm[k]] = k;
+
+		const IndexVector &rp = a.getRowPtr();
+		const IndexVector &ci = a.getColIndex();
+		std::vector<unsigned int> flag(n), Lnz(n, 0);
+		parent.assign(n, -1);
+
+		for(unsigned int k = 0; k < n; k++) {
+			flag[k] = k;
+			const unsigned int row = perm[k];
+			for(unsigned int q = rp[row]; q < rp[row + 1]; q++) {
+				//  Sobe pela árvore a partir de cada entrada da parte inferior da linha k.
+				for(unsigned int i = pinv[ci[q]]; i < k and flag[i] != k; i = parent[i]) {
+					if(parent[i] == -1)
+						parent[i] = k;
+					Lnz[i]++;
+					flag[i] = k;
+				}
+			}
+		}
+
+		Lp.assign(n + 1, 0);
+		for(unsigned int k = 0; k < n; k++)
+			Lp[k + 1] = Lp[k] + Lnz[k];
+
+		Li.assign(Lp[n], 0);
+		Lx.assign(Lp[n], 0);
+		D.assign(n, 0);
+
+		size = n;
+		patternHash = hashPattern(a);
+		analyzed = true;
+		factored = false;
+	}
+
+	//  Fatoração numérica "up-looking": a linha k de L é obtida resolvendo um sistema
+	//triangular esparso cujo padrão é o caminho na árvore de eliminação.
+	bool SparseCholesky::factorize(const SparseMatrix &a) {
+		if(not matchesPattern(a))
+			throw std::string("Padrao de esparsidade diferente do analisado");
+
+		const unsigned int n = size;
+		const IndexVector &rp = a.getRowPtr();
+		const IndexVector &ci = a.getColIndex();
+		const double *av = a.getValues();
+
+		double maxDiag = 0;
+		for(unsigned int i = 0; i < n; i++)
+			maxDiag = std::max(maxDiag, std::fabs(a.get(i, i)));
+		const double tol = maxDiag * n * 1e-14;
+		const double offTol = maxDiag * 1e-8;
+
+		std::vector<double> Y(n, 0);
+		std::vector<unsigned int> pattern(n), flag(n), Lnz(n);
+		factored = false;
+
+		for(unsigned int k = 0; k < n; k++) {
+			Y[k] = 0;
+			unsigned int top = n;
+			flag[k] = k;
+			Lnz[k] = 0;
+
+			const unsigned int row = perm[k];
+			for(unsigned int q = rp[row]; q < rp[row + 1]; q++) {
+				unsigned int i = pinv[ci[q]];
+				if(i > k)
+					continue;
+				Y[i] += av[q];
+
+				unsigned int len = 0;
+				for(; flag[i] != k; i = parent[i]) {
+					pattern[len++] = i;
+					flag[i] = k;
+				}
+				while(len > 0)
+					pattern[--top] = pattern[--len];
+			}
+
+			double d = Y[k];
+			Y[k] = 0;
+			for(; top < n; top++) {
+				const unsigned int i = pattern[top];
+				const double yi = Y[i];
+				Y[i] = 0;
+
+				const unsigned int p2 = Lp[i] + Lnz[i];
+				for(unsigned int p = Lp[i]; p < p2; p++)
+					Y[Li[p]] -= Lx[p] * yi;
+
+				double lki = 0;
+				if(D[i] != 0) {
+					lki = yi / D[i];
+					d -= lki * yi;
+				}
+				//  Pivô nulo: em uma matriz semidefinida a coluna também é nula.
+				else if(std::fabs(yi) > offTol)
+					return false;
+
+				Li[p2] = k;
+				Lx[p2] = lki;
+				Lnz[i]++;
+			}
+
+			//  Pivô negativo: a matriz não é positiva semidefinida.
+			if(d < -tol)
+				return false;
+
+			D[k] = (d <= tol) ? 0 : d;
+		}
+		factored = true;
+		return true;
+	}
+
+	void SparseCholesky::solve(Matrix &b) const {
+		Workspace w;
+		solve(b, w);
+	}
+
+	void SparseCholesky::solve(Matrix &b, Workspace &w) const {
+		if(not factored)
+			throw std::string("Matriz nao fatorada");
+
+		const unsigned int n = size;
+		if(b.getRowNumber() != n)
+			throw std::string("Matrizes incompativeis.");
+
+		double *y = w.get<double>(SOLVE_SLOT, n);
+		for(unsigned int c = 0; c < b.getColNumber(); c++) {
+			for(unsigned int k = 0; k < n; k++)
+				y[k] = b(perm[k], c);
+
+			//  Substituição direta com L, coluna a coluna.
+			for(unsigned int j = 0; j < n; j++)
+				for(unsigned int p = Lp[j]; p < Lp[j + 1]; p++)
+					y[Li[p]] -= Lx[p] * y[j];
+
+			//  Divisão por D. Pivôs nulos levam a incógnita a zero.
+			for(unsigned int j = 0; j < n; j++)
+				y[j] = (D[j] == 0) ? 0 : y[j] / D[j];
+
+			//  Substituição reversa com Lt.
+			for(unsigned int j = n; j-- > 0;)
+				for(unsigned int p = Lp[j]; p < Lp[j + 1]; p++)
+					y[j] -= Lx[p] * y[Li[p]];
+
+			for(unsigned int k = 0; k < n; k++)
+				b(perm[k], c) = y[k];
+		}
+	}
+
+	//  Mesmo método C1 da versão densa. Como o padrão de v*vt está contido no padrão de A,
+	//os elementos de w que se tornam não nulos pertencem às colunas de L já existentes.
+	bool SparseCholesky::update(const std::vector<double> &v, double alpha) {
+		if(v.size() != size)
+			throw std::string("Matrizes incompativeis.");
+
+		Workspace work;
+		return update(v.data(), alpha, work);
+	}
+
+	bool SparseCholesky::update(const double *v, double alpha, Workspace &work) {
+		if(not factored)
+			throw std::string("Matriz nao fatorada");
+
+		const unsigned int n = size;
+		double *w = work.get<double>(UPDATE_SLOT, n);
+		for(unsigned int k = 0; k < n; k++)
+			w[k] = v[perm[k]];
+
+		for(unsigned int j = 0; j < n and alpha != 0; j++) {
+			const double p = w[j];
+			if(p == 0)
+				continue;
+
+			const double d = D[j];
+			const double dNew = d + alpha * p * p;
+
+			//  Pivôs nulos e cancelamentos severos exigem uma nova fatoração.
+			if(d == 0 or dNew <= d * 1e-12) {
+				factored = false;
+				return false;
+			}
+
+			const double beta = p * alpha / dNew;
+			alpha *= d / dNew;
+			D[j] = dNew;
+
+			for(unsigned int q = Lp[j]; q < Lp[j + 1]; q++) {
+				w[Li[q]] -= p * Lx[q];
+				Lx[q] += beta * w[Li[q]];
+			}
+		}
+		return true;
+	}
+
+	bool SparseCholesky::matchesPattern(const SparseMatrix &a) const {
+		return analyzed and a.getRowNumber() == size and a.getColNumber() == size and hashPattern(a) == patternHash;
+	}
+
+	bool SparseCholesky::isAnalyzed() const { return analyzed; }
+	bool SparseCholesky::isFactored() const { return factored; }
+	unsigned int SparseCholesky::getFactorNonZeros() const { return Lp.empty() ? 0 : Lp.back(); }
+	const std::vector<unsigned int> &SparseCholesky::getPermutation() const { return perm; }
+
+   
+	//  Construtor inicializa A e B com a e b, respectivamente. Além de fazer o vetor x receber o vetor
+	//nulo como chute inicial (acho que é uma escolha sensata).
+	//  As matrizes recebidas por valor são movidas para os membros, sem uma segunda cópia.
+	EquationSystem::EquationSystem(Matrix a, Matrix b, matrixStructure s) : A(std::move(a)), sparse(false), B(std::move(b)), x(B.getRowNumber(), B.getColNumber()), structure(s),
+		method(AUTOMATIC_SOLVER), preconditioner(IC0_PRECONDITIONER), report({AUTOMATIC_SOLVER, 0, 0, 0, false, getBackend().getName(), 0, 0}), factored(false), factoredMethod(AUTOMATIC_SOLVER),
+		woodburyU(0, 0), woodburyZ(0, 0), fixedFactored(false), fixedSingular(false){
+		if(A.getRowNumber() != B.getRowNumber())
+			throw "Matrizes incompatíveis";
+	}
+
+	//  Sistemas esparsos mantêm A vazia até que seja necessário um método denso.
+	EquationSystem::EquationSystem(SparseMatrix a, Matrix b, matrixStructure s) 
+		: A(0, 0), S(std::move(a)), sparse(true), B(std::move(b)), x(B.getRowNumber(), B.getColNumber()), structure(s),
+		method(AUTOMATIC_SOLVER), preconditioner(IC0_PRECONDITIONER), report({AUTOMATIC_SOLVER, 0, 0, 0, false, getBackend().getName(), 0, 0}), factored(false), factoredMethod(AUTOMATIC_SOLVER),
+		woodburyU(0, 0), woodburyZ(0, 0), fixedFactored(false), fixedSingular(false){
+		if(S.getRowNumber() != B.getRowNumber())
+			throw "Matrizes incompatíveis";
+	}
+
+	void EquationSystem::setCoefficients(SparseMatrix a, matrixStructure s) {
+		if(a.getRowNumber() != B.getRowNumber())
+			throw "Matrizes incompatíveis";
+
+		S = std::move(a);
+		sparse = true;
+		structure = s;
+		diagonalScale.clear();
+		A = Matrix(0, 0);
+		factored = false;
+	}
+
+	void EquationSystem::setConstants(const Matrix &b) {
+		if(b.getRowNumber() != B.getRowNumber())
+			throw "Matrizes incompatíveis";
+
+		B = b;
+		if(x.getColNumber() != b.getColNumber())
+			x = Matrix(b.getRowNumber(), b.getColNumber());
+	}
+
+	bool EquationSystem::isFactored() const { return factored; }
+
+	//  Estimativa a partir das dimensões: matrizes densas com n*m valores; esparsas com um
+	//valor e um índice por entrada; fatorações com os fatores, pivôs e permutações.
+	std::size_t EquationSystem::getBytes() const {
+		const std::size_t n = B.getRowNumber();
+		std::size_t bytes = workspace.getBytes() + sizeof(double) * (std::size_t(A.getRowNumber()) * A.getColNumber() +
+		                    std::size_t(B.getRowNumber()) * B.getColNumber() + std::size_t(x.getRowNumber()) * x.getColNumber());
+		if(sparse)
+			bytes += S.getNonZeros() * (sizeof(double) + sizeof(unsigned int)) + (n + 1) * sizeof(unsigned int);
+
+		//  Os fatores de FixedMatrix ficam no próprio objeto.
+		if(factored and not (factoredMethod == LU_SOLVER and fixedFactored)) {
+			if(factoredMethod == LU_SOLVER)
+				bytes += n * n * sizeof(double) + n * (sizeof(int) + sizeof(unsigned int)) +
+				         sizeof(double) * (std::size_t(woodburyU.getRowNumber()) * woodburyU.getColNumber() +
+				                           std::size_t(woodburyZ.getRowNumber()) * woodburyZ.getColNumber());
+			else if(factoredMethod == MIXED_PRECISION_SOLVER)
+				bytes += n * n * sizeof(float) + n * sizeof(unsigned int);
+			else if(sparse)
+				bytes += sparseCholesky.getFactorNonZeros() * (sizeof(double) + sizeof(unsigned int)) + 
+				         n * (sizeof(double) + 4 * sizeof(unsigned int));
+			else
+				bytes += n * n * sizeof(double);
+		}
+		return bytes;
+	}
+
+	bool EquationSystem::updateCoefficients(const Matrix &W, const std::vector<double> &sigma) {
+		const unsigned int n = B.getRowNumber();
+		if(W.getRowNumber() != n or W.getColNumber() != sigma.size())
+			throw "Matrizes incompatíveis";
+
+		//  Linhas não nulas de uma coluna de W: a modificação só toca os pares delas. Ficam
+		//na memória de trabalho, para que atualizações repetidas não aloquem.
+		unsigned int *rows = workspace.get<unsigned int>(ROWS_SLOT, n);
+		const auto nonZeroRows = [&](unsigned int c) {
+			unsigned int count = 0;
+			for(unsigned int i = 0; i < n; i++)
+				if(W(i, c) != 0 and sigma[c] != 0)
+					rows[count++] = i;
+			return count;
+		};
+
+		//  O erro acumulado por modificações sucessivas é limitado pela soma dos módulos das
+		//parcelas, e não pelo valor atual: na diagonal, essa soma é guardada desde a montagem.
+		if(diagonalScale.size() != n) {
+			diagonalScale.assign(n, 0.0);
+			for(unsigned int i = 0; i < n; i++) {
+				if(not sparse)
+					diagonalScale[i] = std::fabs(A(i, i));
+				else
+					for(unsigned int k = S.getRowPtr()[i]; k < S.getRowPtr()[i + 1]; k++)
+						if(S.getColIndex()[k] == i)
+							diagonalScale[i] = std::fabs(S.getValues()[k]);
+			}
+		}
+
+		//  Soma value a uma entrada (da diagonal i, ou fora dela se i == n). Um cancelamento
+		//deixaria um resíduo de arredondamento onde a montagem direta daria zero, e a fatoração
+		//o tomaria por um pivô; a entrada é zerada e, se for da diagonal, a fatoração em cache
+		//deixa de valer.
+		bool cancelled = false;
+		const auto accumulate = [&](double &entry, double value, unsigned int i) {
+			const double sum = entry + value;
+			const double scale = (i < n) ? diagonalScale[i] + std::fabs(value) : std::fabs(entry) + std::fabs(value);
+			if(value != 0 and std::fabs(sum) <= cancellationTolerance * scale) {
+				entry = 0;
+				cancelled = cancelled or i < n;
+				if(i < n)
+					diagonalScale[i] = 0;
+			}
+			else {
+				entry = sum;
+				if(i < n)
+					diagonalScale[i] = scale;
+			}
+		};
+
+		//  Atualiza a matriz dos coeficientes guardada, usada no resíduo e nas refatorações.
+		bool samePattern = true;
+		if(sparse) {
+			const IndexVector &rp = S.getRowPtr();
+			const IndexVector &ci = S.getColIndex();
+			double *v = S.getValues();
+			std::vector<Triplet> extra;
+
+			for(unsigned int c = 0; c < sigma.size(); c++) {
+				const unsigned int count = nonZeroRows(c);
+				for(unsigned int a = 0; a < count; a++) {
+					for(unsigned int b = 0; b < count; b++) {
+						const unsigned int i = rows[a], j = rows[b];
+						const double value = sigma[c] * W(i, c) * W(j, c);
+						IndexVector::const_iterator it = std::lower_bound(ci.begin() + rp[i], ci.begin() + rp[i + 1], j);
+						if(it != ci.begin() + rp[i + 1] and *it == j)
+							accumulate(v[it - ci.begin()], value, i == j ? i : n);
+						else
+							extra.push_back({i, j, value});
+					}
+				}
+			}
+
+			//  Entradas fora do padrão: a matriz é remontada e a análise simbólica refeita.
+			if(not extra.empty()) {
+				for(unsigned int i = 0; i < n; i++)
+					for(unsigned int k = rp[i]; k < rp[i + 1]; k++)
+						extra.push_back({i, ci[k], v[k]});
+				S = SparseMatrix(n, n, extra);
+				samePattern = false;
+			}
+		}
+		else {
+			for(unsigned int c = 0; c < sigma.size(); c++) {
+				const unsigned int count = nonZeroRows(c);
+				for(unsigned int a = 0; a < count; a++)
+					for(unsigned int b = 0; b < count; b++)
+						accumulate(A(rows[a], rows[b]), sigma[c] * W(rows[a], c) * W(rows[b], c), a == b ? rows[a] : n);
+			}
+		}
+
+		if(not factored)
+			return false;
+		if(not samePattern or cancelled) {
+			factored = false;
+			return false;
+		}
+
+		//  A fatoração de FixedMatrix é simplesmente refeita sobre os membros: custa menos que
+		//a correção de Woodbury e não aloca.
+		if(factoredMethod == LU_SOLVER and fixedFactored) {
+			if(not fixedSingular)
+				fixedFactorize();
+			factored = not fixedSingular;
+			return factored;
+		}
+
+		double *u = workspace.get<double>(MODIFICATION_SLOT, n);
+		for(unsigned int c = 0; c < sigma.size() and factored; c++) {
+			const unsigned int count = nonZeroRows(c);
+			if(count == 0)
+				continue;
+
+			std::fill(u, u + n, 0.0);
+			for(unsigned int a = 0; a < count; a++)
+				u[rows[a]] = W(rows[a], c);
+
+			if(factoredMethod == LU_SOLVER)
+				factored = woodburyUpdate(u, sigma[c]);
+			//  A fatoração em precisão simples é simplesmente refeita.
+			else if(factoredMethod == MIXED_PRECISION_SOLVER)
+				factored = false;
+			else
+				factored = sparse ? sparseCholesky.update(u, sigma[c], workspace) : cholesky.update(u, sigma[c], workspace);
+		}
+		return factored;
+	}
+
+	bool EquationSystem::woodburyUpdate(const double *u, double sigma) {
+		const unsigned int n = B.getRowNumber();
+		const unsigned int k = woodburySigma.size();
+		//  Com um pivô nulo, A^-1*u não existe e a fórmula não se aplica.
+		if(k >= maxWoodburyRank or lu.isSingular())
+			return false;
+
+		//  Acrescenta u a U e A^-1*u a Z.
+		Matrix z(n);
+		for(unsigned int i = 0; i < n; i++)
+			z(i, 0) = u[i];
+		lu.solve(z);
+
+		Matrix U(n, k + 1), Z(n, k + 1);
+		for(unsigned int i = 0; i < n; i++) {
+			for(unsigned int c = 0; c < k; c++) {
+				U(i, c) = woodburyU(i, c);
+				Z(i, c) = woodburyZ(i, c);
+			}
+			U(i, k) = u[i];
+			Z(i, k) = z(i, 0);
+		}
+		woodburyU = U;
+		woodburyZ = Z;
+		woodburySigma.push_back(sigma);
+
+		//  Capacitância K = diag(1/sigma) + Ut*Z.
+		Matrix K = woodburyU.transpose() * woodburyZ;
+		for(unsigned int c = 0; c <= k; c++)
+			K(c, c) += 1 / woodburySigma[c];
+		woodburyK.factorize(K);
+		return not woodburyK.isSingular();
+	}
+
+	void EquationSystem::setMethod(solverMethod m, preconditionerType p) {
+		//  Uma fatoração em cache só vale para o método que a produziu.
+		if(m != method)
+			factored = false;
+		method = m;
+		preconditioner = p;
+	}
+
+	SolverReport EquationSystem::getReport() const { return report; }
+ 
+	//  Gauss-Seidel multicolorido com sobre-relaxação adaptativa (w = 1 reproduz o método 
+	//clássico). A partida é a solução atual.
+	void EquationSystem::gaussSeidel(double tol, unsigned int maxIter) {
+		//  Sistemas densos são percorridos em CSR, sem as entradas nulas.
+		const SparseMatrix dropped = sparse ? SparseMatrix() : SparseMatrix(A);
+
+		MulticolorSOR sor(tol, maxIter);
+		sor.setup(sparse ? S : dropped);
+		const SolverReport r = sor.solve(B, x);
+
+		report.method = GAUSS_SEIDEL_SOLVER;
+		report.iterations = r.iterations;
+		report.converged = r.converged;
+	}
+
+	void EquationSystem::luSolve() {
+		if(A.getRowNumber() != A.getColNumber())
+			throw std::string("Matriz dos coeficientes nao e quadrada");
+
+		//  Fatora uma cópia de A; as matrizes do sistema não são alteradas.
+		if(not factored) {
+			const std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+			lu.factorize(A);
+			report.factorizationTime += secondsSince(t);
+			factored = true;
+			factoredMethod = LU_SOLVER;
+			fixedFactored = false;
+			woodburySigma.clear();
+		}
+
+		//  A solução é escrita diretamente em x.
+		lu.solve(B, x);
+
+		//  Correção das modificações acumuladas: x -= Z*K^-1*Ut*x.
+		if(not woodburySigma.empty()) {
+			Matrix t = woodburyU.transpose() * x;
+			woodburyK.solve(t);
+			x -= woodburyZ * t;
+		}
+	}
+
+	void EquationSystem::mixedPrecisionSolve() {
+		if(A.getRowNumber() != A.getColNumber())
+			throw std::string("Matriz dos coeficientes nao e quadrada");
+
+		const unsigned int n = A.getRowNumber();
+		const unsigned int m = B.getColNumber();
+
+		if(not factored) {
+			const std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+			singleLU.factorize(A);
+			report.factorizationTime += secondsSince(t);
+			//  Um pivô nulo em precisão simples não diz nada sobre a matriz original.
+			if(singleLU.isSingular()) {
+				luSolve();
+				report.method = LU_SOLVER;
+				return;
+			}
+			factored = true;
+			factoredMethod = MIXED_PRECISION_SOLVER;
+		}
+
+		//  Critério do dsgesv: a coluna c está resolvida quando 
+		//||r_c|| <= ||x_c|| * ||A|| * eps * sqrt(n), em norma infinito.
+		double normA = 0;
+		for(unsigned int i = 0; i < n; i++) {
+			double s = 0;
+			for(unsigned int j = 0; j < n; j++)
+				s += std::fabs(A(i, j));
+			normA = std::max(normA, s);
+		}
+		const double scale = normA * std::numeric_limits<double>::epsilon() * std::sqrt(double(n));
+
+		x = B;
+		singleLU.solve(x);
+
+		Matrix r(n, m);
+		std::vector<double> acc(m);
+		double previous = std::numeric_limits<double>::infinity();
+		unsigned int steps = 0;
+
+		while(true) {
+			//  r = B - A*x em precisão dupla, sobre a matriz original.
+			for(unsigned int i = 0; i < n; i++) {
+				std::fill(acc.begin(), acc.end(), 0.0);
+				for(unsigned int j = 0; j < n; j++) {
+					const double a = A(i, j);
+					if(a == 0)
+						continue;
+					for(unsigned int c = 0; c < m; c++)
+						acc[c] += a * x(j, c);
+				}
+				for(unsigned int c = 0; c < m; c++)
+					r(i, c) = B(i, c) - acc[c];
+			}
+
+			//  Pior coluna, em múltiplos da tolerância de cada uma.
+			double worst = 0;
+			for(unsigned int c = 0; c < m; c++) {
+				double normR = 0, normX = 0;
+				for(unsigned int i = 0; i < n; i++) {
+					normR = std::max(normR, std::fabs(r(i, c)));
+					normX = std::max(normX, std::fabs(x(i, c)));
+				}
+				const double tol = normX * scale;
+				worst = std::max(worst, (normR <= tol) ? 0 : (tol == 0 ? std::numeric_limits<double>::infinity() : normR / tol));
+			}
+			if(worst == 0)
+				break;
+
+			//  Estagnação: o resíduo deve cair pelo menos à metade a cada passo.
+			if(steps == maxRefinementSteps or not (worst < 0.5 * previous)) {
+				factored = false;
+				luSolve();
+				report.method = LU_SOLVER;
+				report.iterations = steps;
+				return;
+			}
+			previous = worst;
+
+			singleLU.solve(r);
+			x += r;
+			steps++;
+		}
+
+		report.method = MIXED_PRECISION_SOLVER;
+		report.iterations = steps;
+	}
+
+	bool EquationSystem::choleskySolve() {
+		if(not factored) {
+			const std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+			const bool ok = cholesky.factorize(A);
+			report.factorizationTime += secondsSince(t);
+			if(not ok)
+				return false;
+			factored = true;
+			factoredMethod = CHOLESKY_SOLVER;
+		}
+
+		x = B;
+		cholesky.solve(x);
+		return true;
+	}
+
+	bool EquationSystem::sparseCholeskySolve() {
+		if(not factored) {
+			const std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+
+			//  A análise simbólica só é refeita se o padrão de esparsidade mudou.
+			if(not sparseCholesky.matchesPattern(S))
+				sparseCholesky.analyze(S);
+
+			const bool ok = sparseCholesky.factorize(S);
+			report.factorizationTime += secondsSince(t);
+			if(not ok)
+				return false;
+			factored = true;
+			factoredMethod = CHOLESKY_SOLVER;
+		}
+
+		x = B;
+		sparseCholesky.solve(x, workspace);
+		return true;
+	}
+
+	bool EquationSystem::conjugateGradientSolve(double tol, unsigned int maxIter) {
+		//  O precondicionador é sempre preparado sobre uma matriz esparsa; no caso denso, 
+		//as entradas nulas são descartadas.
+		const SparseMatrix dropped = sparse ? SparseMatrix() : SparseMatrix(A);
+		const SparseMatrix &pattern = sparse ? S : dropped;
+
+		JacobiPreconditioner jacobi;
+		SSORPreconditioner ssor;
+		IC0Preconditioner ic0;
+		Preconditioner *p = nullptr;
+
+		switch(preconditioner) {
+			case JACOBI_PRECONDITIONER:
+				p = &jacobi;
+			break;
+			case SSOR_PRECONDITIONER:
+				p = &ssor;
+			break;
+			case IC0_PRECONDITIONER:
+				p = &ic0;
+			break;
+			default:
+			break;
+		}
+		if(p != nullptr)
+			p->setup(pattern);
+
+		ConjugateGradient cg(tol, maxIter, p, &workspace);
+		SolverReport r = sparse ? cg.solve(S, B, x) : cg.solve(A, B, x);
+
+		report.method = CONJUGATE_GRADIENT_SOLVER;
+		report.iterations = r.iterations;
+		report.converged = r.converged;
+		return r.converged;
+	}
+
+	//  Fatora a matriz com FixedMatrix<N, N>, se n == N; senão, tenta a dimensão abaixo. A
+	//fatoração é feita na pilha, e os fatores e a permutação são copiados para factor e perm.
+	template <unsigned int N>
+	static bool fixedSizeFactorize(unsigned int n, const Matrix &A, const SparseMatrix &S, bool sparse, double *factor,
+	                               unsigned int *perm) {
+		if(n != N) {
+			if constexpr (N > 1)
+				return fixedSizeFactorize<N - 1>(n, A, S, sparse, factor, perm);
+			else
+				return false;
+		}
+
+		FixedMatrix<N, N> a;
+		if(sparse) {
+			const IndexVector &rp = S.getRowPtr();
+			const IndexVector &ci = S.getColIndex();
+			const double *v = S.getValues();
+			for(unsigned int i = 0; i < N; i++)
+				for(unsigned int k = rp[i]; k < rp[i + 1]; k++)
+					a(i, ci[k]) = v[k];
+		}
+		else
+			a = FixedMatrix<N, N>(A);
+
+		std::array<unsigned int, N> p;
+		const bool regular = a.factorizeLU(p);
+		for(unsigned int i = 0; i < N; i++) {
+			perm[i] = p[i];
+			for(unsigned int j = 0; j < N; j++)
+				factor[i * N + j] = a(i, j);
+		}
+		return regular;
+	}
+
+	//  Resolve o sistema a partir dos fatores de fixedSizeFactorize, se n == N; senão, tenta a
+	//dimensão abaixo. Os fatores, a permutação e cada coluna das constantes ficam na pilha.
+	template <unsigned int N>
+	static void fixedSizeSolve(unsigned int n, const double *factor, const unsigned int *perm, const Matrix &B, Matrix &x) {
+		if(n != N) {
+			if constexpr (N > 1)
+				fixedSizeSolve<N - 1>(n, factor, perm, B, x);
+			return;
+		}
+
+		FixedMatrix<N, N> a;
+		std::array<unsigned int, N> p;
+		for(unsigned int i = 0; i < N; i++) {
+			p[i] = perm[i];
+			for(unsigned int j = 0; j < N; j++)
+				a(i, j) = factor[i * N + j];
+		}
+
+		for(unsigned int c = 0; c < B.getColNumber(); c++) {
+			FixedMatrix<N, 1> b;
+			for(unsigned int i = 0; i < N; i++)
+				b(i, 0) = B(i, c);
+			a.solveLU(p, b);
+			for(unsigned int i = 0; i < N; i++)
+				x(i, c) = b(i, 0);
+		}
+	}
+
+	void EquationSystem::fixedFactorize() {
+		const std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+		fixedSingular = not fixedSizeFactorize<maxFixedSize>(B.getRowNumber(), A, S, sparse, fixedFactor.data(), fixedPerm.data());
+		report.factorizationTime += secondsSince(t);
+		factored = true;
+		factoredMethod = LU_SOLVER;
+		fixedFactored = true;
+		woodburySigma.clear();
+	}
+
+	void EquationSystem::fixedSolve() {
+		fixedSizeSolve<maxFixedSize>(B.getRowNumber(), fixedFactor.data(), fixedPerm.data(), B, x);
+	}
+
+	//  O resíduo é acumulado linha a linha, sem matrizes temporárias.
+	double EquationSystem::relativeResidual() const {
+		const unsigned int m = B.getColNumber();
+		const IndexVector &rp = S.getRowPtr();
+		const IndexVector &ci = S.getColIndex();
+		const double *v = S.getValues();
+		double r = 0, b = 0;
+
+		for(unsigned int i = 0; i < B.getRowNumber(); i++) {
+			for(unsigned int c = 0; c < m; c++) {
+				double ri = B(i, c);
+				if(sparse) {
+					for(unsigned int k = rp[i]; k < rp[i + 1]; k++)
+						ri -= v[k] * x(ci[k], c);
+				}
+				else {
+					for(unsigned int j = 0; j < A.getColNumber(); j++)
+						ri -= A(i, j) * x(j, c);
+				}
+				r += ri * ri;
+				b += B(i, c) * B(i, c);
+			}
+		}
+		return (b == 0) ? std::sqrt(r) : std::sqrt(r / b);
+	}
+
+	solverMethod EquationSystem::planMethod(double tol, unsigned int maxIter) {
+		SolverPlanner &planner = getSolverPlanner();
+		const MatrixProperties p = sparse ? SolverPlanner::analyze(S, structure) : SolverPlanner::analyze(A, structure);
+
+		solverMethod m;
+		if(planner.lookup(p.topology, m))
+			return m;
+
+		const std::vector<SolverPlan> plans = planner.rank(p, tol);
+		if(not planner.isCalibrationEnabled() or plans.size() == 1)
+			return plans.front().method;
+
+		//  Calibração: cada candidato parte do mesmo chute inicial e de uma fatoração nova.
+		//Os métodos densos convertem a matriz esparsa, que é restaurada para o próximo.
+		//Candidatos muito mais caros que o primeiro pelo modelo não são medidos.
+		const Matrix start(x);
+		const bool wasSparse = sparse;
+		const unsigned int count = std::min<std::size_t>(planner.getCandidateCount(), plans.size());
+		double bestTime = std::numeric_limits<double>::infinity();
+		m = plans.front().method;
+		for(unsigned int k = 0; k < count and plans[k].cost <= maxCalibrationRatio * plans.front().cost; k++) {
+			x = start;
+			factored = false;
+			const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+			const bool ok = solveWith(plans[k].method, tol, maxIter);
+			const double t = secondsSince(t0);
+			if(ok and t < bestTime) {
+				bestTime = t;
+				m = plans[k].method;
+			}
+			if(wasSparse and not sparse) {
+				A = Matrix(0, 0);
+				sparse = true;
+			}
+		}
+
+		x = start;
+		factored = false;
+		report = {method, 0, 0, 0, true, getBackend().getName(), 0, 0};
+		planner.record(p.topology, m);
+		return m;
+	}
+
+	bool EquationSystem::solveWith(solverMethod m, double tol, unsigned int maxIter) {
+		switch(m) {
+			//  Se o gradiente conjugado não convergir no modo automático, a solução parcial
+			//é descartada.
+			case CONJUGATE_GRADIENT_SOLVER:
+				if(conjugateGradientSolve(tol, maxIter) or method == CONJUGATE_GRADIENT_SOLVER)
+					return true;
+				x = Matrix(B.getRowNumber(), B.getColNumber());
+				return false;
+
+			//  A fatoração LDLt só falha se a matriz não for positiva semidefinida.
+			case CHOLESKY_SOLVER:
+				if(structure != SYMMETRIC)
+					return false;
+				report.method = CHOLESKY_SOLVER;
+				report.iterations = 0;
+				return sparse ? sparseCholeskySolve() : choleskySolve();
+
+			//  Gauss-Seidel opera também sobre a matriz esparsa.
+			case GAUSS_SEIDEL_SOLVER:
+				gaussSeidel(tol, maxIter);
+				return report.converged or method == GAUSS_SEIDEL_SOLVER;
+
+			default:
+				break;
+		}
+
+		//  Os métodos restantes são densos.
+		if(sparse) {
+			A = S.toDense();
+			sparse = false;
+		}
+
+		if(m == MIXED_PRECISION_SOLVER)
+			mixedPrecisionSolve();
+		else {
+			luSolve();
+			report.method = LU_SOLVER;
+			report.iterations = 0;
+			report.converged = true;
+		}
+		return true;
+	}
+
+	//  Função que resolve o sistema linear.
+	void EquationSystem::computeSolution(double tol, unsigned int maxIter) {
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		report = {method, 0, 0, 0, true, getBackend().getName(), 0, 0};
+
+		if(structure == UNKNOWN_STRUCTURE)
+			structure = (sparse ? S.isSymmetric() : A.isSymmetric()) ? SYMMETRIC : GENERAL;
+
+		const unsigned int n = B.getRowNumber();
+		const bool automatic = (method == AUTOMATIC_SOLVER);
+		bool solved = false;
+
+		//  Com uma fatoração em cache, apenas as substituições são refeitas.
+		if(factored) {
+			if(factoredMethod == LU_SOLVER and fixedFactored)
+				fixedSolve();
+			else if(factoredMethod == LU_SOLVER)
+				luSolve();
+			else if(factoredMethod == MIXED_PRECISION_SOLVER)
+				mixedPrecisionSolve();
+			else if(sparse)
+				sparseCholeskySolve();
+			else
+				choleskySolve();
+			if(factoredMethod != MIXED_PRECISION_SOLVER)
+				report.method = factoredMethod;
+			solved = true;
+		}
+
+		//  Sistemas com até maxFixedSize incógnitas são fatorados por FixedMatrix, sem
+		//alocações. Os fatores ficam nos membros de tamanho fixo, como qualquer fatoração em
+		//cache. Um método explícito que não seja a LU segue para solveWith.
+		if(not solved and n > 0 and n <= maxFixedSize and (automatic or method == LU_SOLVER) and 
+		   (sparse ? S.getColNumber() : A.getColNumber()) == n) {
+			fixedFactorize();
+			fixedSolve();
+			report.method = LU_SOLVER;
+			solved = true;
+		}
+
+		if(not solved)
+			solved = solveWith(automatic ? planMethod(tol, maxIter) : method, tol, maxIter);
+
+		//  Se o método escolhido falhar (LDLt de uma matriz que não é positiva semidefinida,
+		//ou um método iterativo que não convergiu no modo automático), a fatoração LU resolve.
+		if(not solved)
+			solveWith(LU_SOLVER, tol, maxIter);
+
+		report.residual = relativeResidual();
+		report.time = secondsSince(start);
+		report.bytes = getBytes();
+	}
+
+	Matrix EquationSystem::getSolution(double tol, unsigned int maxIter) {
+		computeSolution(tol, maxIter);
+		return x;
+	}
+
+	//  A cópia reaproveita o buffer de out; x continua sendo o chute inicial dos métodos
+	//iterativos na próxima solução.
+	void EquationSystem::getSolution(Matrix &out, double tol, unsigned int maxIter) {
+		computeSolution(tol, maxIter);
+		out = x;
+	}
+
+	Matrix EquationSystem::solve(const Matrix &b, double tol, unsigned int maxIter) {
+		setConstants(b);
+		return getSolution(tol, maxIter);
+	}
+
+	void EquationSystem::solve(const Matrix &b, Matrix &out, double tol, unsigned int maxIter) {
+		setConstants(b);
+		getSolution(out, tol, maxIter);
 	}
-}
\ No newline at end of file
+}
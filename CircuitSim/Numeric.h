@@ -14,224 +14,2082 @@
 #ifndef NUMERIC_H
 #define NUMERIC_H
 
-#include "Circuit.h"
-
+#include <array>
 #include <vector>
 #include <iostream>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
 
 namespace NM {
-   
+
    /*************************************************************************
-    * Declaração da classe Matrix.
+    * Declaração da classe Arena.
     *
-    * Representa uma matriz matemática e implementa suas operações.
+    * Alocador monotônico: cada alocação apenas avança um ponteiro dentro
+    * de um bloco, e liberações individuais não fazem nada. Toda a memória
+    * é devolvida de uma vez por reset(), que mantém os blocos para o 
+    * próximo ciclo. Depois de um reset(), os blocos usados no ciclo 
+    * anterior são fundidos em um só, de modo que um ciclo que se repete
+    * passa a caber inteiro no primeiro bloco.
+    *************************************************************************/
+	class Arena {
+	private:
+	   /*************************************************************************
+    	* Bloco de memória da arena.
+    	*************************************************************************/
+		struct Block {
+			unsigned char *data; /**< Início do bloco.*/
+			std::size_t size; /**< Tamanho do bloco, em bytes.*/
+		};
+
+		std::vector<Block> blocks; /**< Blocos reservados (o primeiro é o maior).*/
+		std::size_t current; /**< Bloco em uso.*/
+		std::size_t offset; /**< Bytes ocupados no bloco em uso.*/
+		std::size_t used; /**< Bytes entregues desde o último reset().*/
+		std::size_t peak; /**< Maior valor de used já observado.*/
+		std::size_t blockSize; /**< Tamanho mínimo dos novos blocos.*/
+
+	   /*************************************************************************
+    	* Reserva um novo bloco e o torna o bloco em uso.
+    	*
+    	* @param bytes Tamanho mínimo do bloco.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void grow(std::size_t bytes);
+
+	public:
+	   /*************************************************************************
+    	* Construtor da classe Arena.
+    	*
+    	* Nenhuma memória é reservada até a primeira alocação.
+    	*
+    	* @param initialBytes Tamanho do primeiro bloco.
+    	*************************************************************************/
+		explicit Arena(std::size_t initialBytes = 64 * 1024);
+
+	   /*************************************************************************
+    	* Desconstrutor da classe Arena.
+    	*
+    	* Devolve todos os blocos ao sistema.
+    	*************************************************************************/
+		~Arena();
+
+		Arena(const Arena &) = delete;
+		Arena &operator=(const Arena &) = delete;
+
+	   /*************************************************************************
+    	* Aloca um bloco alinhado.
+    	*
+    	* @param bytes Tamanho, em bytes.
+    	* @param align Alinhamento (potência de dois).
+		*
+    	* @return Ponteiro para o início do bloco.
+    	*************************************************************************/
+		void *allocate(std::size_t bytes, std::size_t align);
+
+	   /*************************************************************************
+    	* Devolve toda a memória entregue desde o último reset().
+    	*
+    	* Nenhum objeto alocado na arena pode ser usado depois desta chamada.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void reset();
+
+		std::size_t getCapacity() const; /**< Retorna o total de bytes reservados em blocos.*/
+		std::size_t getUsed() const; /**< Retorna os bytes entregues desde o último reset().*/
+		std::size_t getPeak() const; /**< Retorna o maior número de bytes entregues em um ciclo.*/
+	};
+
+
+   /*************************************************************************
+    * Getter para a arena da thread atual.
+    *
+    * @return Arena instalada pelo ArenaScope mais interno da thread, ou nulo.
+    *************************************************************************/
+	Arena *currentArena();
+
+
+   /*************************************************************************
+    * Declaração da classe ArenaScope.
+    *
+    * Enquanto existir, os containers do namespace NM criados na thread 
+    * atual alocam da arena dada. Os escopos podem ser aninhados. Objetos 
+    * criados dentro do escopo não devem ser usados depois do reset() da
+    * arena; atribuí-los (por cópia ou movimento) a objetos criados fora do
+    * escopo é seguro, pois os elementos são copiados para a memória do
+    * destino.
+    *************************************************************************/
+	class ArenaScope {
+	private:
+		Arena *previous; /**< Arena instalada antes deste escopo.*/
+
+	public:
+	   /*************************************************************************
+    	* Construtor da classe ArenaScope.
+    	*
+    	* @param a Arena a ser usada pelos containers criados no escopo.
+    	*************************************************************************/
+		explicit ArenaScope(Arena &a);
+
+	   /*************************************************************************
+    	* Desconstrutor da classe ArenaScope.
+    	*
+    	* Restaura a arena anterior.
+    	*************************************************************************/
+		~ArenaScope();
+
+		ArenaScope(const ArenaScope &) = delete;
+		ArenaScope &operator=(const ArenaScope &) = delete;
+	};
+
+
+   /*************************************************************************
+    * Declaração do alocador AlignedAllocator.
+    *
+    * Alocador utilizado pelos containers do namespace NM. Garante que o
+    * início de cada bloco alocado esteja alinhado em Align bytes, o que
+    * permite o uso de instruções vetoriais sobre os dados da matriz.
+    *
+    * O alocador guarda a arena corrente no momento em que é construído 
+    * (ver ArenaScope); sem arena, usa o operador new. O alocador não é
+    * propagado em atribuições e trocas, e cópias de containers tomam a
+    * arena corrente no momento da cópia: um container nunca passa a 
+    * depender de uma arena que não escolheu.
     ************************************************************************/
-	class Matrix {
+	template <typename T, std::size_t Align = 64>
+	class AlignedAllocator {
 	private:
-		std::vector<std::vector<double>> realMatrix; /**< Implementação concreta da matriz.*/
-		unsigned int rowNumber; /**< Número de linhas da matriz.*/
-		unsigned int colNumber; /**< Número de colunas da matriz.*/
-	
+		Arena *arena; /**< Arena de origem da memória (nulo para o operador new).*/
+
 	public:
-	   /*********************************************************************************
-    	* Construtor da classe Matrix.
+		typedef T value_type; /**< Tipo dos elementos alocados.*/
+		typedef std::false_type propagate_on_container_copy_assignment; /**< Atribuições mantêm o alocador do destino.*/
+		typedef std::false_type propagate_on_container_move_assignment; /**< Atribuições mantêm o alocador do destino.*/
+		typedef std::false_type propagate_on_container_swap; /**< Trocas exigem alocadores iguais.*/
+		typedef std::false_type is_always_equal; /**< Alocadores de arenas diferentes são diferentes.*/
+
+		template <typename U>
+		struct rebind { typedef AlignedAllocator<U, Align> other; };
+
+		AlignedAllocator() noexcept : arena(currentArena()) {}
+
+		explicit AlignedAllocator(Arena *a) noexcept : arena(a) {}
+
+		template <typename U>
+		AlignedAllocator(const AlignedAllocator<U, Align> &a) noexcept : arena(a.getArena()) {}
+
+	   /*************************************************************************
+    	* Aloca um bloco alinhado.
     	*
-        * Constrói uma matriz com um número escolhido linhas, preenchida com zeros.
-    	* 
-    	* @param r Número de linhas.
-    	*********************************************************************************/
-		Matrix(unsigned int r);
-		
+    	* @param n Número de elementos.
+		*
+    	* @return Ponteiro para o início do bloco.
+    	*************************************************************************/
+		T *allocate(std::size_t n) {
+			if(arena != nullptr)
+				return static_cast<T*>(arena->allocate(n * sizeof(T), std::max(Align, alignof(T))));
+			return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+		}
 
-		/*************************************************************************
-    	* Construtor da classe Matrix.
+	   /*************************************************************************
+    	* Libera um bloco alocado por allocate.
     	*
-    	* Constrói uma matriz com um número escolhido de linhas e colunas, 
-    	* preenchida com zeros.
+    	* Blocos da arena só são devolvidos por Arena::reset().
+    	*
+    	* @param p Ponteiro para o início do bloco.
+    	* @param n Número de elementos.
+    	*************************************************************************/
+		void deallocate(T *p, std::size_t n) noexcept {
+			(void)n;
+			if(arena == nullptr)
+				::operator delete(p, std::align_val_t(Align));
+		}
+
+	   /*************************************************************************
+    	* Alocador de uma cópia de container.
+    	*
+    	* @return Alocador da arena corrente.
+    	*************************************************************************/
+		AlignedAllocator select_on_container_copy_construction() const noexcept { return AlignedAllocator(); }
+
+		Arena *getArena() const noexcept { return arena; } /**< Retorna a arena de origem da memória.*/
+
+		template <typename U>
+		bool operator== (const AlignedAllocator<U, Align> &a) const noexcept { return arena == a.getArena(); }
+
+		template <typename U>
+		bool operator!= (const AlignedAllocator<U, Align> &a) const noexcept { return arena != a.getArena(); }
+	};
+
+	typedef std::vector<unsigned int, AlignedAllocator<unsigned int>> IndexVector; /**< Vetor de índices dos containers do namespace NM.*/
+
+
+   /*************************************************************************
+    * Declaração da classe BasicVectorView.
+    *
+    * Visão (não proprietária) de uma sequência de elementos igualmente 
+    * espaçados na memória. É utilizada para representar linhas e colunas 
+    * de uma matriz sem copiar os seus elementos.
+    *
+    * O parâmetro T é double para visões que permitem escrita e const double
+    * para visões somente de leitura.
+    ************************************************************************/
+	template <typename T>
+	class BasicVectorView {
+	private:
+		T *ptr; /**< Ponteiro para o primeiro elemento da visão.*/
+		unsigned int size; /**< Número de elementos da visão.*/
+		std::ptrdiff_t stride; /**< Distância, em elementos, entre dois elementos consecutivos.*/
+
+	public:
+	   /*************************************************************************
+    	* Construtor da classe BasicVectorView.
+    	*
+    	* @param p Ponteiro para o primeiro elemento.
+    	* @param n Número de elementos.
+    	* @param s Distância entre elementos consecutivos.
+    	*************************************************************************/
+		BasicVectorView(T *p, unsigned int n, std::ptrdiff_t s) : ptr(p), size(n), stride(s) {}
+
+	   /*************************************************************************
+    	* Conversão de uma visão de escrita para uma visão de leitura.
+    	*************************************************************************/
+		template <typename U>
+		BasicVectorView(const BasicVectorView<U> &v) : ptr(v.data()), size(v.getSize()), stride(v.getStride()) {}
+
+	   /*************************************************************************
+    	* Sobrecarga do operador [] da classe BasicVectorView.
+    	*
+    	* Acesso sem verificação de limites, como em std::vector.
+    	*
+    	* @param index Índice do elemento.
+		*
+    	* @return Referência ao elemento.
+    	*************************************************************************/
+		T &operator[] (unsigned int index) const { return ptr[index * stride]; }
+
+	   /*************************************************************************
+    	* Acesso com verificação de limites.
+    	*
+    	* @param index Índice do elemento.
+		*
+    	* @return Referência ao elemento.
+    	*************************************************************************/
+		T &at(unsigned int index) const {
+			if(index >= size)
+				throw std::string("Acesso invalido");
+			return ptr[index * stride];
+		}
+
+		unsigned int getSize() const { return size; } /**< Retorna o número de elementos.*/
+		std::ptrdiff_t getStride() const { return stride; } /**< Retorna a distância entre elementos.*/
+		T *data() const { return ptr; } /**< Retorna o ponteiro para o primeiro elemento.*/
+
+	   /*************************************************************************
+    	* Copia os elementos da visão para um std::vector.
+    	*
+    	* @return Vector com os elementos da visão.
+    	*************************************************************************/
+		std::vector<double> toVector() const {
+			std::vector<double> temp(size);
+			for(unsigned int i = 0; i < size; i++)
+				temp[i] = ptr[i * stride];
+			return temp;
+		}
+	};
+
+	typedef BasicVectorView<double> VectorView; /**< Visão de escrita de uma linha ou coluna.*/
+	typedef BasicVectorView<const double> ConstVectorView; /**< Visão de leitura de uma linha ou coluna.*/
+
+
+   /*************************************************************************
+    * Declaração da classe BasicMatrixView.
+    *
+    * Visão (não proprietária) de um bloco bidimensional de elementos,
+    * descrito por um ponteiro inicial e pelas distâncias entre linhas e
+    * entre colunas. Permite representar sub-blocos e transpostas de uma
+    * matriz sem cópia.
+    ************************************************************************/
+	template <typename T>
+	class BasicMatrixView {
+	private:
+		T *ptr; /**< Ponteiro para o elemento (0, 0) da visão.*/
+		unsigned int rowNumber; /**< Número de linhas da visão.*/
+		unsigned int colNumber; /**< Número de colunas da visão.*/
+		std::ptrdiff_t rowStride; /**< Distância, em elementos, entre duas linhas consecutivas.*/
+		std::ptrdiff_t colStride; /**< Distância, em elementos, entre duas colunas consecutivas.*/
+
+	public:
+	   /*************************************************************************
+    	* Construtor da classe BasicMatrixView.
     	*
+    	* @param p Ponteiro para o elemento (0, 0).
     	* @param r Número de linhas.
     	* @param c Número de colunas.
+    	* @param rs Distância entre linhas.
+    	* @param cs Distância entre colunas.
+    	*************************************************************************/
+		BasicMatrixView(T *p, unsigned int r, unsigned int c, std::ptrdiff_t rs, std::ptrdiff_t cs)
+			: ptr(p), rowNumber(r), colNumber(c), rowStride(rs), colStride(cs) {}
+
+	   /*************************************************************************
+    	* Conversão de uma visão de escrita para uma visão de leitura.
+    	*************************************************************************/
+		template <typename U>
+		BasicMatrixView(const BasicMatrixView<U> &v) 
+			: ptr(v.data()), rowNumber(v.getRowNumber()), colNumber(v.getColNumber()),
+			  rowStride(v.getRowStride()), colStride(v.getColStride()) {}
+
+	   /*************************************************************************
+    	* Acesso sem verificação de limites, para uso em laços internos.
+    	*
+    	* @param i Linha.
+    	* @param j Coluna.
 		*
-    	* @overload
+    	* @return Referência ao elemento (i, j).
     	*************************************************************************/
-		Matrix(unsigned int r, unsigned int c);
+		T &operator() (unsigned int i, unsigned int j) const { return ptr[i * rowStride + j * colStride]; }
 
-		/*************************************************************************
-    	* Sobrecarga do operador * da classe Matrix.
+	   /*************************************************************************
+    	* Acesso com verificação de limites.
+    	*
+    	* @param i Linha.
+    	* @param j Coluna.
+		*
+    	* @return Referência ao elemento (i, j).
+    	*************************************************************************/
+		T &at(unsigned int i, unsigned int j) const {
+			if(i >= rowNumber or j >= colNumber)
+				throw std::string("Acesso invalido");
+			return (*this)(i, j);
+		}
+
+	   /*************************************************************************
+    	* Sobrecarga do operador [] da classe BasicMatrixView.
     	*
-    	* Multiplica duas matrizes e retorna o resultado.
+    	* @param index Linha.
+		*
+    	* @return Visão da linha index.
+    	*************************************************************************/
+		BasicVectorView<T> operator[] (unsigned int index) const { return row(index); }
+
+	   /*************************************************************************
+    	* Visão de uma linha.
     	*
-    	* @param &m1 referência à matriz que à direita.
+    	* @param i Índice da linha.
+		*
+    	* @return Visão da linha i.
+    	*************************************************************************/
+		BasicVectorView<T> row(unsigned int i) const {
+			if(i >= rowNumber)
+				throw std::string("Acesso invalido");
+			return BasicVectorView<T>(ptr + i * rowStride, colNumber, colStride);
+		}
+
+	   /*************************************************************************
+    	* Visão de uma coluna.
     	*
-		* @return Matriz à esquerda.
-    	* @overload
+    	* @param j Índice da coluna.
+		*
+    	* @return Visão da coluna j.
     	*************************************************************************/
-		Matrix operator* (Matrix &m1);
-		
-	  /*************************************************************************
-    	* Sobrecarga do operador *= da classe Matrix.
+		BasicVectorView<T> col(unsigned int j) const {
+			if(j >= colNumber)
+				throw std::string("Acesso invalido");
+			return BasicVectorView<T>(ptr + j * colStride, rowNumber, rowStride);
+		}
+
+	   /*************************************************************************
+    	* Visão de um sub-bloco.
     	*
-    	* Multiplica duas matrizes e insere o resultado na matriz à esquerda.
+    	* @param r0 Linha inicial.
+    	* @param c0 Coluna inicial.
+    	* @param r Número de linhas do bloco.
+    	* @param c Número de colunas do bloco.
+		*
+    	* @return Visão do bloco.
+    	*************************************************************************/
+		BasicMatrixView block(unsigned int r0, unsigned int c0, unsigned int r, unsigned int c) const {
+			if(r0 + r > rowNumber or c0 + c > colNumber)
+				throw std::string("Acesso invalido");
+			return BasicMatrixView(ptr + r0 * rowStride + c0 * colStride, r, c, rowStride, colStride);
+		}
+
+	   /*************************************************************************
+    	* Visão transposta.
     	*
-    	* @param &m1 referência à matriz à direita.
+    	* Troca as distâncias entre linhas e colunas, sem copiar os elementos.
 		*
-    	* @overload
+    	* @return Visão transposta.
     	*************************************************************************/
-		void operator*= (Matrix &m1);	
-		
+		BasicMatrixView transpose() const { 
+			return BasicMatrixView(ptr, colNumber, rowNumber, colStride, rowStride); 
+		}
 
-		/*************************************************************************
-    	* Sobrecarga do operador + da classe Matrix.
+		unsigned int getRowNumber() const { return rowNumber; } /**< Retorna o número de linhas.*/
+		unsigned int getColNumber() const { return colNumber; } /**< Retorna o número de colunas.*/
+		std::ptrdiff_t getRowStride() const { return rowStride; } /**< Retorna a distância entre linhas.*/
+		std::ptrdiff_t getColStride() const { return colStride; } /**< Retorna a distância entre colunas.*/
+		T *data() const { return ptr; } /**< Retorna o ponteiro para o elemento (0, 0).*/
+	};
+
+	typedef BasicMatrixView<double> MatrixView; /**< Visão de escrita de uma matriz.*/
+	typedef BasicMatrixView<const double> ConstMatrixView; /**< Visão de leitura de uma matriz.*/
+	typedef BasicMatrixView<float> FloatMatrixView; /**< Visão de escrita de uma matriz em precisão simples.*/
+	typedef BasicMatrixView<const float> ConstFloatMatrixView; /**< Visão de leitura de uma matriz em precisão simples.*/
+
+   
+   /*************************************************************************
+    * Fornece uma identificação para a estrutura da matriz dos coeficientes
+    * de um sistema.
+    *
+    * Permite que quem monta o sistema informe propriedades já conhecidas
+    * da matriz, dispensando a verificação durante a solução.
+    *************************************************************************/
+	enum matrixStructure {
+		UNKNOWN_STRUCTURE, /**< Estrutura desconhecida; a simetria é verificada na solução.*/
+		GENERAL, /**< Matriz qualquer.*/
+		SYMMETRIC /**< Matriz simétrica (possivelmente positiva definida).*/
+	};
+
+
+	class Matrix;
+	template <typename E> class MatrixTranspose;
+	template <typename E, typename Op> class MatrixUnaryExpression;
+	struct AbsOperation;
+
+
+   /*************************************************************************
+    * Declaração da classe MatrixExpression.
+    *
+    * Base (CRTP) das expressões matriciais. Somas, diferenças, negações,
+    * valores absolutos, transpostas e produtos de matrizes não são
+    * calculados quando escritos: cada operador retorna um pequeno objeto
+    * que descreve a operação, e a expressão inteira é avaliada de uma só
+    * vez ao ser atribuída a uma Matrix, sem matrizes intermediárias.
+    *
+    * As expressões guardam referências às matrizes envolvidas e não devem
+    * sobreviver a elas; o uso pretendido é atribuí-las diretamente a uma
+    * Matrix.
+    *
+    * Toda expressão E fornece getRowNumber(), getColNumber(), o acesso 
+    * E(i, j), references(p), que indica se a matriz com buffer p é lida, e
+    * aliases(p), que indica se o destino p não pode receber a avaliação 
+    * diretamente por ser lido em posições diferentes das escritas.
+    *************************************************************************/
+	template <typename E>
+	class MatrixExpression {
+	public:
+	   /*************************************************************************
+    	* Acesso à expressão concreta.
     	*
-    	* Soma duas matrizes e retorna o resultado.
+    	* @return Referência para a expressão derivada.
+    	*************************************************************************/
+		const E &derived() const { return static_cast<const E &>(*this); }
+
+	   /*************************************************************************
+    	* Transpõe a expressão.
     	*
-    	* @param &m1 referência à matriz à direita.
-    	* @return Matriz à esquerda.
+    	* Retorna uma visão transposta, sem cópia: a transposta só é escrita
+		* em memória se for atribuída a uma Matrix.
     	*
-		* @overload
+    	* @return Expressão transposta.
     	*************************************************************************/
-		Matrix operator+ (Matrix &m1);
-		
+		MatrixTranspose<E> transpose() const;
+
 	   /*************************************************************************
-    	* Sobrecarga do operador += da classe Matrix.
+    	* Pega o "valor absoluto" da expressão.
     	*
-    	* Soma as entradas de duas matrizes e insere o resultado na primeira.
+    	* @return Expressão com as entradas em termos absolutos.
+    	*************************************************************************/
+		MatrixUnaryExpression<E, AbsOperation> Abs() const;
+
+	   /*************************************************************************
+    	* Avalia a expressão sobre um destino.
     	*
-    	* @param &m1 referência à matriz que à direita.
-    	* @overload
+    	* Implementação padrão, elemento a elemento; as expressões que sabem
+		* fazer melhor (transposta, produto) a substituem.
+    	*
+    	* @param dst Visão do destino, com as dimensões da expressão.
+		*
+    	* @return Void.
     	*************************************************************************/
-		void operator+= (Matrix &m1);
-		
-		/*************************************************************************
-    	* Sobrecarga do operador - da classe Matrix.
+		void evaluateTo(const MatrixView &dst) const {
+			const E &e = derived();
+			for(unsigned int i = 0; i < e.getRowNumber(); i++)
+				for(unsigned int j = 0; j < e.getColNumber(); j++)
+					dst(i, j) = e(i, j);
+		}
+
+	   /*************************************************************************
+    	* Acumula a expressão sobre um destino.
     	*
-    	* Subtrai as entradas da matriz à direita da matriz à esquerda e retorna 
-    	* o resultado.
-    	* @param &m1 referência à matriz à direita.
+    	* Calcula dst += alpha*E.
+    	*
+    	* @param dst Visão do destino, com as dimensões da expressão.
+    	* @param alpha Escala da expressão.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void addTo(const MatrixView &dst, double alpha) const {
+			const E &e = derived();
+			for(unsigned int i = 0; i < e.getRowNumber(); i++)
+				for(unsigned int j = 0; j < e.getColNumber(); j++)
+					dst(i, j) += alpha * e(i, j);
+		}
+	};
+
+
+   /*************************************************************************
+    * Forma como uma expressão guarda seus operandos.
+    *
+    * Matrizes são guardadas por referência; sub-expressões, que são objetos
+    * pequenos e temporários, são guardadas por valor.
+    *************************************************************************/
+	template <typename E>
+	struct ExpressionOperand { typedef const E type; };
+
+	template <>
+	struct ExpressionOperand<Matrix> { typedef const Matrix &type; };
+
+
+	struct SumOperation { static double apply(double a, double b) { return a + b; } }; /**< Soma elemento a elemento.*/
+	struct DifferenceOperation { static double apply(double a, double b) { return a - b; } }; /**< Diferença elemento a elemento.*/
+	struct NegationOperation { static double apply(double a) { return -a; } }; /**< Negação elemento a elemento.*/
+	struct AbsOperation { static double apply(double a) { return std::fabs(a); } }; /**< Valor absoluto elemento a elemento.*/
+
+
+   /*************************************************************************
+    * Declaração da classe MatrixBinaryExpression.
+    *
+    * Operação elemento a elemento entre duas expressões de mesmas dimensões.
+    *************************************************************************/
+	template <typename L, typename R, typename Op>
+	class MatrixBinaryExpression : public MatrixExpression<MatrixBinaryExpression<L, R, Op>> {
+	private:
+		typename ExpressionOperand<L>::type left; /**< Operando à esquerda.*/
+		typename ExpressionOperand<R>::type right; /**< Operando à direita.*/
+
+	public:
+		MatrixBinaryExpression(const L &l, const R &r) : left(l), right(r) {
+			if(l.getRowNumber() != r.getRowNumber() or l.getColNumber() != r.getColNumber())
+				throw std::string("Matrizes incompativeis.");
+		}
+
+		double operator() (unsigned int i, unsigned int j) const { return Op::apply(left(i, j), right(i, j)); }
+		unsigned int getRowNumber() const { return left.getRowNumber(); }
+		unsigned int getColNumber() const { return left.getColNumber(); }
+		bool references(const double *p) const { return left.references(p) or right.references(p); }
+		bool aliases(const double *p) const { return left.aliases(p) or right.aliases(p); }
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe MatrixUnaryExpression.
+    *
+    * Operação elemento a elemento sobre uma expressão.
+    *************************************************************************/
+	template <typename E, typename Op>
+	class MatrixUnaryExpression : public MatrixExpression<MatrixUnaryExpression<E, Op>> {
+	private:
+		typename ExpressionOperand<E>::type operand; /**< Operando.*/
+
+	public:
+		explicit MatrixUnaryExpression(const E &e) : operand(e) {}
+
+		double operator() (unsigned int i, unsigned int j) const { return Op::apply(operand(i, j)); }
+		unsigned int getRowNumber() const { return operand.getRowNumber(); }
+		unsigned int getColNumber() const { return operand.getColNumber(); }
+		bool references(const double *p) const { return operand.references(p); }
+		bool aliases(const double *p) const { return operand.aliases(p); }
+	};
+
+
+	template <typename L, typename R>
+	using MatrixSum = MatrixBinaryExpression<L, R, SumOperation>; /**< Soma de duas expressões.*/
+
+	template <typename L, typename R>
+	using MatrixDifference = MatrixBinaryExpression<L, R, DifferenceOperation>; /**< Diferença de duas expressões.*/
+
+	template <typename E>
+	using MatrixNegation = MatrixUnaryExpression<E, NegationOperation>; /**< Negação de uma expressão.*/
+
+	template <typename E>
+	using MatrixAbs = MatrixUnaryExpression<E, AbsOperation>; /**< Valor absoluto de uma expressão.*/
+
+
+   /*************************************************************************
+    * Declaração da classe MatrixTranspose.
+    *
+    * Transposta de uma expressão, lida com os índices trocados. Quando é
+    * atribuída a uma Matrix, é escrita em blocos pequenos, para que origem
+    * e destino fiquem na cache.
+    *************************************************************************/
+	template <typename E>
+	class MatrixTranspose : public MatrixExpression<MatrixTranspose<E>> {
+	private:
+		typename ExpressionOperand<E>::type operand; /**< Expressão transposta.*/
+
+	public:
+		explicit MatrixTranspose(const E &e) : operand(e) {}
+
+		double operator() (unsigned int i, unsigned int j) const { return operand(j, i); }
+		unsigned int getRowNumber() const { return operand.getColNumber(); }
+		unsigned int getColNumber() const { return operand.getRowNumber(); }
+		bool references(const double *p) const { return operand.references(p); }
+		bool aliases(const double *p) const { return operand.references(p); }
+		const E &getOperand() const { return operand; } /**< Retorna a expressão transposta.*/
+
+		void evaluateTo(const MatrixView &dst) const {
+			//  Um bloco de 32x32 doubles (8 KiB) cabe com folga na cache L1 tanto para a 
+			//origem quanto para o destino.
+			const unsigned int block = 32;
+			const unsigned int r = operand.getRowNumber(), c = operand.getColNumber();
+
+			for(unsigned int ii = 0; ii < r; ii += block) {
+				const unsigned int iEnd = std::min(ii + block, r);
+				for(unsigned int jj = 0; jj < c; jj += block) {
+					const unsigned int jEnd = std::min(jj + block, c);
+					for(unsigned int i = ii; i < iEnd; i++)
+						for(unsigned int j = jj; j < jEnd; j++)
+							dst(j, i) = operand(i, j);
+				}
+			}
+		}
+	};
+
+
+   /*************************************************************************
+    * Multiplica duas visões e acumula o resultado.
+    *
+    * Calcula c += alpha*a*b. As visões podem ter distâncias quaisquer (uma
+    * transposta, por exemplo), mas c não pode se sobrepor a a ou b.
+    *
+    * @param a Visão à esquerda.
+    * @param b Visão à direita.
+    * @param c Visão do destino.
+    * @param alpha Escala do produto.
+	*
+    * @return Void.
+    *************************************************************************/
+	void multiplyAdd(const ConstMatrixView &a, const ConstMatrixView &b, const MatrixView &c, double alpha);
+
+
+   /*************************************************************************
+    * Declaração da classe MatrixProduct.
+    *
+    * Produto de duas expressões. Ao ser atribuído, os operandos que são
+    * matrizes (ou transpostas de matrizes) são usados diretamente pelo
+    * núcleo de multiplicação, e os demais são avaliados uma única vez.
+    *************************************************************************/
+	template <typename L, typename R>
+	class MatrixProduct : public MatrixExpression<MatrixProduct<L, R>> {
+	private:
+		typename ExpressionOperand<L>::type left; /**< Operando à esquerda.*/
+		typename ExpressionOperand<R>::type right; /**< Operando à direita.*/
+
+	public:
+		MatrixProduct(const L &l, const R &r) : left(l), right(r) {
+			if(l.getColNumber() != r.getRowNumber())
+				throw std::string("Matrizes incompativeis.");
+		}
+
+		//  Acesso isolado a um elemento: produto interno da linha i pela coluna j.
+		double operator() (unsigned int i, unsigned int j) const {
+			double s = 0;
+			for(unsigned int k = 0; k < left.getColNumber(); k++)
+				s += left(i, k) * right(k, j);
+			return s;
+		}
+
+		unsigned int getRowNumber() const { return left.getRowNumber(); }
+		unsigned int getColNumber() const { return right.getColNumber(); }
+		bool references(const double *p) const { return left.references(p) or right.references(p); }
+		bool aliases(const double *p) const { return references(p); }
+
+		void evaluateTo(const MatrixView &dst) const;
+		void addTo(const MatrixView &dst, double alpha) const;
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe Matrix.
+    *
+    * Representa uma matriz matemática e implementa suas operações.
+    *
+    * Os elementos são armazenados em um único buffer contíguo e alinhado,
+    * em ordem de linhas (row-major): o elemento (i, j) está na posição
+    * i*getRowStride() + j*getColStride().
+    ************************************************************************/
+	class Matrix : public MatrixExpression<Matrix> {
+	private:
+		std::vector<double, AlignedAllocator<double>> realMatrix; /**< Buffer contíguo com as entradas da matriz.*/
+		unsigned int rowNumber; /**< Número de linhas da matriz.*/
+		unsigned int colNumber; /**< Número de colunas da matriz.*/
+	
+	public:
+	   /*********************************************************************************
+    	* Construtor da classe Matrix.
+    	*
+        * Constrói uma matriz com um número escolhido linhas, preenchida com zeros.
+    	* 
+    	* @param r Número de linhas.
+    	*********************************************************************************/
+		Matrix(unsigned int r);
+		
+
+		/*************************************************************************
+    	* Construtor da classe Matrix.
+    	*
+    	* Constrói uma matriz com um número escolhido de linhas e colunas, 
+    	* preenchida com zeros.
+    	*
+    	* @param r Número de linhas.
+    	* @param c Número de colunas.
+		*
+    	* @overload
+    	*************************************************************************/
+		Matrix(unsigned int r, unsigned int c);
+
+		/*************************************************************************
+    	* Construtor da classe Matrix.
+    	*
+    	* Constrói uma matriz copiando os elementos de uma visão.
+    	*
+    	* @param v Visão cujos elementos serão copiados.
+		*
+    	* @overload
+    	*************************************************************************/
+		explicit Matrix(const ConstMatrixView &v);
+
+		/*************************************************************************
+    	* Construtor de cópia da classe Matrix.
+    	*
+    	* @param m1 Matriz a ser copiada.
+		*
+    	* @overload
+    	*************************************************************************/
+		Matrix(const Matrix &m1) = default;
+
+		/*************************************************************************
+    	* Construtor de movimento da classe Matrix.
+    	*
+    	* Toma o buffer de m1, que fica vazia (0 x 0), sem copiar elementos.
+    	*
+    	* @param m1 Matriz a ser movida.
+		*
+    	* @overload
+    	*************************************************************************/
+		Matrix(Matrix &&m1) noexcept;
+
+		/*************************************************************************
+    	* Construtor da classe Matrix.
+    	*
+    	* Constrói uma matriz avaliando uma expressão em uma única passada.
+    	*
+    	* @param e Expressão a ser avaliada.
+		*
+    	* @overload
+    	*************************************************************************/
+		template <typename E>
+		Matrix(const MatrixExpression<E> &e) : Matrix(e.derived().getRowNumber(), e.derived().getColNumber()) {
+			e.derived().evaluateTo(view());
+		}
+
+		/*************************************************************************
+    	* Sobrecarga do operador *= da classe Matrix.
+    	*
+    	* Multiplica a matriz à esquerda pela expressão à direita e insere o 
+		* resultado na matriz à esquerda.
+    	*
+    	* @param &e referência à expressão à direita.
+		*
+    	* @overload
+    	*************************************************************************/
+		template <typename E>
+		Matrix &operator*= (const MatrixExpression<E> &e);
+
+	   /*************************************************************************
+    	* Sobrecarga do operador += da classe Matrix.
+    	*
+    	* Soma a expressão à direita diretamente sobre as entradas da matriz.
+    	*
+    	* @param &e referência à expressão à direita.
+    	* @overload
+    	*************************************************************************/
+		template <typename E>
+		Matrix &operator+= (const MatrixExpression<E> &e);
+
+	   /*************************************************************************
+    	* Sobrecarga do operador -= da classe Matrix.
+    	*
+    	* Subtrai a expressão à direita diretamente das entradas da matriz.
+    	*
+    	* @param &e referência à expressão à direita.
+    	* @overload
+    	*************************************************************************/
+		template <typename E>
+		Matrix &operator-= (const MatrixExpression<E> &e);
+
+
+	   /*************************************************************************
+    	* Sobrecarga do operador = da classe Matrix.
+    	*
+    	* Substitui as entradas da matriz à esquerda pelas entradas da matriz à direita.
+		* O buffer existente é reaproveitado se tiver capacidade suficiente.
+    	*
+    	* @param &m1 referência à matriz que à direita.
+		*
+		* @return Referência à matriz à esquerda.
+    	* @overload
+    	*************************************************************************/
+		Matrix &operator= (const Matrix &m1);
+
+
+	   /*************************************************************************
+    	* Sobrecarga do operador = da classe Matrix, por movimento.
+    	*
+    	* Toma o buffer da matriz à direita, que fica vazia (0 x 0). Se as duas
+		* matrizes vierem de arenas diferentes (ver ArenaScope), os elementos
+		* são copiados para o buffer da matriz à esquerda.
+    	*
+    	* @param &m1 referência à matriz à direita.
+		*
+		* @return Referência à matriz à esquerda.
+    	* @overload
+    	*************************************************************************/
+		Matrix &operator= (Matrix &&m1);
+
+
+	   /*************************************************************************
+    	* Sobrecarga do operador = da classe Matrix.
+    	*
+    	* Avalia a expressão à direita diretamente sobre a matriz. Se a 
+		* expressão lê a própria matriz em posições diferentes das escritas
+		* (transpostas e produtos), ela é avaliada antes em uma matriz auxiliar.
+    	*
+    	* @param &e referência à expressão à direita.
+		*
+		* @return Referência à matriz à esquerda.
+    	* @overload
+    	*************************************************************************/
+		template <typename E>
+		Matrix &operator= (const MatrixExpression<E> &e);
+		
+
+	   /*************************************************************************
+    	* Sobrecarga do operador [] da classe Matrix.
+    	*
+    	* Permite acesso direto aos valores presentes na matriz.
+    	*
+    	* @param index número da linha que será considerada.
+		*
+    	* @return Visão da linha do índice index.
+    	* @overload
+    	*************************************************************************/
+		VectorView operator[] (unsigned int index);
+		ConstVectorView operator[] (unsigned int index) const;
+
+
+	   /*************************************************************************
+    	* Acesso a um elemento sem verificação de limites.
+    	*
+    	* Destinado aos laços internos dos algoritmos numéricos, onde os índices
+		* já são garantidamente válidos.
+    	*
+    	* @param i Linha.
+    	* @param j Coluna.
+		*
+    	* @return Referência ao elemento (i, j).
+    	*************************************************************************/
+		double &operator() (unsigned int i, unsigned int j) { return realMatrix[i * colNumber + j]; }
+		const double &operator() (unsigned int i, unsigned int j) const { return realMatrix[i * colNumber + j]; }
+
+
+	   /*************************************************************************
+    	* Acesso a um elemento com verificação de limites.
+    	*
+    	* @param i Linha.
+    	* @param j Coluna.
+		*
+    	* @return Referência ao elemento (i, j).
+    	*************************************************************************/
+		double &at(unsigned int i, unsigned int j);
+		const double &at(unsigned int i, unsigned int j) const;
+		
+
+	   /*************************************************************************
+    	* Indica se a matriz é a dona do buffer p.
+    	*
+    	* @param p Buffer do destino de uma atribuição.
+		*
+    	* @return true se p é o buffer desta matriz.
+    	*************************************************************************/
+		bool references(const double *p) const { return p == realMatrix.data(); }
+
+	   /*************************************************************************
+    	* Indica se a matriz impede a avaliação direta sobre p.
+    	*
+    	* Uma matriz é lida nas mesmas posições em que o destino é escrito, 
+		* portanto nunca impede.
+    	*
+    	* @return false.
+    	*************************************************************************/
+		bool aliases(const double *) const { return false; }
+
+
+	   /*************************************************************************
+    	* Verifica se a matriz é simétrica.
+    	*
+    	* Compara cada entrada (i, j) com a entrada (j, i), admitindo uma 
+		* diferença relativa de até tol.
+    	*
+    	* @param tol Tolerância relativa.
+		*
+    	* @return true se a matriz é quadrada e simétrica.
+    	*************************************************************************/
+		bool isSymmetric(double tol = 1e-12) const;
+
+
+	   /*************************************************************************
+    	* Getter para uma coluna.
+    	*
+    	* Retorna uma visão das entradas de uma coluna da matriz.
+    	*
+    	* @param col índice da coluna.
+    	* @return Visão representando a coluna.
+    	* @overload
+    	*************************************************************************/
+		VectorView getCol(unsigned int col);
+		ConstVectorView getCol(unsigned int col) const;
+
+
+	   /*************************************************************************
+    	* Visão de uma linha.
+    	*
+    	* @param i índice da linha.
+    	* @return Visão representando a linha.
+    	*************************************************************************/
+		VectorView row(unsigned int i) { return view().row(i); }
+		ConstVectorView row(unsigned int i) const { return view().row(i); }
+
+
+	   /*************************************************************************
+    	* Visão de uma coluna.
+    	*
+    	* @param j índice da coluna.
+    	* @return Visão representando a coluna.
+    	*************************************************************************/
+		VectorView col(unsigned int j) { return view().col(j); }
+		ConstVectorView col(unsigned int j) const { return view().col(j); }
+
+
+	   /*************************************************************************
+    	* Visão de um sub-bloco da matriz.
+    	*
+    	* @param r0 Linha inicial.
+    	* @param c0 Coluna inicial.
+    	* @param r Número de linhas do bloco.
+    	* @param c Número de colunas do bloco.
+		*
+    	* @return Visão do bloco.
+    	*************************************************************************/
+		MatrixView block(unsigned int r0, unsigned int c0, unsigned int r, unsigned int c) { 
+			return view().block(r0, c0, r, c); 
+		}
+		ConstMatrixView block(unsigned int r0, unsigned int c0, unsigned int r, unsigned int c) const { 
+			return view().block(r0, c0, r, c); 
+		}
+
+
+	   /*************************************************************************
+    	* Visão da matriz inteira.
+    	*
+    	* @return Visão de todos os elementos da matriz.
+    	*************************************************************************/
+		MatrixView view() { return MatrixView(realMatrix.data(), rowNumber, colNumber, colNumber, 1); }
+		ConstMatrixView view() const { return ConstMatrixView(realMatrix.data(), rowNumber, colNumber, colNumber, 1); }
+
+
+	   /*************************************************************************
+    	* Ponteiro para o início do buffer contíguo da matriz.
+    	*
+    	* @return Ponteiro para o elemento (0, 0).
+    	*************************************************************************/
+		double *data() { return realMatrix.data(); }
+		const double *data() const { return realMatrix.data(); }
+
+
+	   /*************************************************************************
+    	* Redimensiona a matriz e a preenche com zeros.
+    	*
+    	* O buffer só é realocado se a nova matriz não couber na capacidade
+		* atual; matrizes de trabalho reaproveitadas entre soluções não alocam.
+    	*
+    	* @param r Número de linhas.
+    	* @param c Número de colunas.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void resize(unsigned int r, unsigned int c);
+
+
+	   /*************************************************************************
+    	* Getter para a quantidade de colunas da matriz.
+    	*
+    	* Retorna a quantidade de colunas da matriz.
+    	*
+    	* @return Número de colunas.
+    	* @overload
+    	*************************************************************************/
+		unsigned int getColNumber() const;
+		
+
+	   /*************************************************************************
+    	* Getter para a quantidade de linhas da matriz.
+    	*
+    	* Retorna a quantidade de linhas da matriz.
+    	*
+    	* @return Número de cinhas.
+    	* @overload
+    	*************************************************************************/
+		unsigned int getRowNumber() const;
+
+
+	   /*************************************************************************
+    	* Getter para a distância, em elementos, entre duas linhas consecutivas.
+    	*
+    	* @return Distância entre linhas.
+    	*************************************************************************/
+		std::ptrdiff_t getRowStride() const { return colNumber; }
+
+
+	   /*************************************************************************
+    	* Getter para a distância, em elementos, entre duas colunas consecutivas.
+    	*
+    	* @return Distância entre colunas.
+    	*************************************************************************/
+		std::ptrdiff_t getColStride() const { return 1; }
+		
+
+		/*************************************************************************
+    	* Troca duas linhas.
+    	*
+    	* Dados dois índices representando duas linhas, troca as entradas dessas
+    	* duas linhas no próprio buffer, sem alocar memória.
+		*
+    	* @param l1 linha 1.
+    	* @param l2 linha 2.
+		*
+    	* @return Void.
+    	* @overload
+    	*************************************************************************/
+		void swapLines(unsigned int l1, unsigned int l2);
+	};
+
+
+   /*************************************************************************
+    * Operando de um produto, na forma de uma visão.
+    *
+    * Expressões quaisquer são avaliadas uma vez em uma matriz auxiliar;
+    * matrizes e transpostas de matrizes são usadas diretamente.
+    *************************************************************************/
+	template <typename E>
+	class ProductOperand {
+	private:
+		Matrix storage; /**< Expressão avaliada.*/
+
+	public:
+		explicit ProductOperand(const E &e) : storage(e) {}
+		ConstMatrixView view() const { return storage.view(); }
+	};
+
+	template <>
+	class ProductOperand<Matrix> {
+	private:
+		const Matrix &matrix; /**< Matriz usada diretamente.*/
+
+	public:
+		explicit ProductOperand(const Matrix &m) : matrix(m) {}
+		ConstMatrixView view() const { return matrix.view(); }
+	};
+
+	template <typename E>
+	class ProductOperand<MatrixTranspose<E>> {
+	private:
+		ProductOperand<E> operand; /**< Operando da transposta.*/
+
+	public:
+		explicit ProductOperand(const MatrixTranspose<E> &t) : operand(t.getOperand()) {}
+		ConstMatrixView view() const { return operand.view().transpose(); }
+	};
+
+
+	template <typename E>
+	MatrixTranspose<E> MatrixExpression<E>::transpose() const { return MatrixTranspose<E>(derived()); }
+
+	template <typename E>
+	MatrixAbs<E> MatrixExpression<E>::Abs() const { return MatrixAbs<E>(derived()); }
+
+	template <typename L, typename R>
+	void MatrixProduct<L, R>::evaluateTo(const MatrixView &dst) const {
+		for(unsigned int i = 0; i < dst.getRowNumber(); i++)
+			for(unsigned int j = 0; j < dst.getColNumber(); j++)
+				dst(i, j) = 0;
+		addTo(dst, 1.0);
+	}
+
+	template <typename L, typename R>
+	void MatrixProduct<L, R>::addTo(const MatrixView &dst, double alpha) const {
+		const ProductOperand<L> a(left);
+		const ProductOperand<R> b(right);
+		multiplyAdd(a.view(), b.view(), dst, alpha);
+	}
+
+	template <typename E>
+	Matrix &Matrix::operator= (const MatrixExpression<E> &e) {
+		const E &x = e.derived();
+
+		//  A expressão lê a própria matriz fora de posição: avalia à parte e troca os buffers.
+		if(x.aliases(data()))
+			return (*this) = Matrix(x);
+
+		if(rowNumber != x.getRowNumber() or colNumber != x.getColNumber())
+			resize(x.getRowNumber(), x.getColNumber());
+		x.evaluateTo(view());
+		return *this;
+	}
+
+	template <typename E>
+	Matrix &Matrix::operator+= (const MatrixExpression<E> &e) {
+		const E &x = e.derived();
+		if(rowNumber != x.getRowNumber() or colNumber != x.getColNumber())
+			throw std::string("Matrizes incompativeis.");
+
+		if(x.aliases(data()))
+			Matrix(x).addTo(view(), 1.0);
+		else
+			x.addTo(view(), 1.0);
+		return *this;
+	}
+
+	template <typename E>
+	Matrix &Matrix::operator-= (const MatrixExpression<E> &e) {
+		const E &x = e.derived();
+		if(rowNumber != x.getRowNumber() or colNumber != x.getColNumber())
+			throw std::string("Matrizes incompativeis.");
+
+		if(x.aliases(data()))
+			Matrix(x).addTo(view(), -1.0);
+		else
+			x.addTo(view(), -1.0);
+		return *this;
+	}
+
+	template <typename E>
+	Matrix &Matrix::operator*= (const MatrixExpression<E> &e) { return (*this) = MatrixProduct<Matrix, E>(*this, e.derived()); }
+
+
+   /*************************************************************************
+    * Sobrecarga do operador + para expressões matriciais.
+    *
+    * @param a Expressão à esquerda.
+    * @param b Expressão à direita.
+	*
+    * @return Expressão da soma, avaliada somente quando atribuída.
+    *************************************************************************/
+	template <typename L, typename R>
+	MatrixSum<L, R> operator+ (const MatrixExpression<L> &a, const MatrixExpression<R> &b) {
+		return MatrixSum<L, R>(a.derived(), b.derived());
+	}
+
+   /*************************************************************************
+    * Sobrecarga do operador - para expressões matriciais.
+    *
+    * @param a Expressão à esquerda.
+    * @param b Expressão à direita.
+	*
+    * @return Expressão da diferença, avaliada somente quando atribuída.
+    *************************************************************************/
+	template <typename L, typename R>
+	MatrixDifference<L, R> operator- (const MatrixExpression<L> &a, const MatrixExpression<R> &b) {
+		return MatrixDifference<L, R>(a.derived(), b.derived());
+	}
+
+   /*************************************************************************
+    * Sobrecarga do operador - unário para expressões matriciais.
+    *
+    * @param a Expressão.
+	*
+    * @return Expressão com sinais invertidos, avaliada somente quando atribuída.
+    *************************************************************************/
+	template <typename E>
+	MatrixNegation<E> operator- (const MatrixExpression<E> &a) {
+		return MatrixNegation<E>(a.derived());
+	}
+
+   /*************************************************************************
+    * Sobrecarga do operador * para expressões matriciais.
+    *
+    * @param a Expressão à esquerda.
+    * @param b Expressão à direita.
+	*
+    * @return Expressão do produto, avaliada somente quando atribuída.
+    *************************************************************************/
+	template <typename L, typename R>
+	MatrixProduct<L, R> operator* (const MatrixExpression<L> &a, const MatrixExpression<R> &b) {
+		return MatrixProduct<L, R>(a.derived(), b.derived());
+	}	
+	
+	
+   /*************************************************************************
+    * Declaração da estrutura Triplet.
+    *
+    * Representa uma entrada (linha, coluna, valor) usada na montagem de uma
+    * SparseMatrix.
+    *************************************************************************/
+	struct Triplet {
+		unsigned int row; /**< Linha da entrada.*/
+		unsigned int col; /**< Coluna da entrada.*/
+		double value; /**< Valor da entrada.*/
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe SparseMatrix.
+    *
+    * Representa uma matriz esparsa no formato CSR (compressed sparse row):
+    * as entradas não nulas de cada linha ficam contíguas, ordenadas por 
+    * coluna. A transposta de uma matriz CSR corresponde ao formato CSC 
+    * (compressed sparse column) da matriz original.
+    *
+    * A estrutura (padrão de esparsidade) é definida na montagem e não 
+    * depende dos valores: entradas montadas com valor zero são mantidas,
+    * de forma que matrizes com a mesma topologia têm o mesmo padrão.
+    *************************************************************************/
+	class SparseMatrix {
+	private:
+		unsigned int rowNumber; /**< Número de linhas da matriz.*/
+		unsigned int colNumber; /**< Número de colunas da matriz.*/
+		IndexVector rowPtr; /**< Início de cada linha em colIndex e values (rowNumber + 1 posições).*/
+		IndexVector colIndex; /**< Coluna de cada entrada armazenada.*/
+		std::vector<double, AlignedAllocator<double>> values; /**< Valor de cada entrada armazenada.*/
+
+	public:
+	   /*************************************************************************
+    	* Construtor da classe SparseMatrix.
+    	*
+    	* Constrói uma matriz esparsa vazia (0 x 0).
+    	*************************************************************************/
+		SparseMatrix();
+
+
+	   /*************************************************************************
+    	* Construtor da classe SparseMatrix.
+    	*
+    	* Constrói uma matriz esparsa r x c sem entradas.
+    	*
+    	* @param r Número de linhas.
+    	* @param c Número de colunas.
+		*
+    	* @overload
+    	*************************************************************************/
+		SparseMatrix(unsigned int r, unsigned int c);
+
+
+	   /*************************************************************************
+    	* Construtor da classe SparseMatrix.
+    	*
+    	* Monta a matriz a partir de uma lista de triplets, em qualquer ordem.
+		* Entradas repetidas na mesma posição são somadas.
+    	*
+    	* @param r Número de linhas.
+    	* @param c Número de colunas.
+    	* @param t Lista de entradas.
+		*
+    	* @overload
+    	*************************************************************************/
+		SparseMatrix(unsigned int r, unsigned int c, const std::vector<Triplet> &t);
+
+
+	   /*************************************************************************
+    	* Construtor da classe SparseMatrix.
+    	*
+    	* Monta a matriz a partir de um array de triplets, para listas guardadas
+		* em containers com outro alocador (por exemplo, de uma arena).
+    	*
+    	* @param r Número de linhas.
+    	* @param c Número de colunas.
+    	* @param t Primeira entrada.
+    	* @param n Número de entradas.
+		*
+    	* @overload
+    	*************************************************************************/
+		SparseMatrix(unsigned int r, unsigned int c, const Triplet *t, std::size_t n);
+
+
+	   /*************************************************************************
+    	* Construtor da classe SparseMatrix.
+    	*
+    	* Converte uma matriz densa, descartando entradas com módulo menor ou
+		* igual a tol.
+    	*
+    	* @param m Matriz densa.
+    	* @param tol Tolerância para descarte.
+		*
+    	* @overload
+    	*************************************************************************/
+		explicit SparseMatrix(const Matrix &m, double tol = 0);
+
+
+	   /*************************************************************************
+    	* Cria uma matriz diagonal.
+    	*
+    	* @param d Entradas da diagonal.
+		*
+    	* @return Matriz esparsa diagonal.
+    	*************************************************************************/
+		static SparseMatrix diagonal(const std::vector<double> &d);
+
+
+	   /*************************************************************************
+    	* Converte a matriz para o formato denso.
+    	*
+    	* @return Matriz densa equivalente.
+    	*************************************************************************/
+		Matrix toDense() const;
+
+
+	   /*************************************************************************
+    	* Transpõe a matriz.
+    	*
+    	* @return Matriz transposta, também em CSR.
+    	*************************************************************************/
+		SparseMatrix transpose() const;
+
+
+	   /*************************************************************************
+    	* Sobrecarga do operador * da classe SparseMatrix.
+    	*
+    	* Multiplica duas matrizes esparsas (algoritmo de Gustavson).
+    	*
+    	* @param m1 Matriz à direita.
+		*
+    	* @return Produto esparso.
+    	*************************************************************************/
+		SparseMatrix operator* (const SparseMatrix &m1) const;
+
+
+	   /*************************************************************************
+    	* Sobrecarga do operador * da classe SparseMatrix.
+    	*
+    	* Multiplica a matriz esparsa por uma matriz densa.
+    	*
+    	* @param m1 Matriz densa à direita.
+		*
+    	* @return Produto denso.
+		*
+		* @overload
+    	*************************************************************************/
+		Matrix operator* (const Matrix &m1) const;
+
+
+	   /*************************************************************************
+    	* Produto matriz-vetor (SpMV).
+    	*
+    	* Calcula y = A*x. Os vetores são acessados por ponteiros contíguos e
+		* x não pode se sobrepor a y.
+    	*
+    	* @param x Vetor de entrada, com getColNumber() elementos.
+    	* @param y Vetor de saída, com getRowNumber() elementos.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void multiply(const double *x, double *y) const;
+
+
+	   /*************************************************************************
+    	* Getter para uma entrada da matriz.
+    	*
+    	* @param i Linha.
+    	* @param j Coluna.
+		*
+    	* @return Valor da entrada (i, j), ou zero se ela não está armazenada.
+    	*************************************************************************/
+		double get(unsigned int i, unsigned int j) const;
+
+
+	   /*************************************************************************
+    	* Verifica se a matriz é simétrica.
+    	*
+    	* @param tol Tolerância relativa.
+		*
+    	* @return true se a matriz é quadrada e simétrica.
+    	*************************************************************************/
+		bool isSymmetric(double tol = 1e-12) const;
+
+
+		unsigned int getRowNumber() const; /**< Retorna o número de linhas.*/
+		unsigned int getColNumber() const; /**< Retorna o número de colunas.*/
+		unsigned int getNonZeros() const; /**< Retorna o número de entradas armazenadas.*/
+		const IndexVector &getRowPtr() const; /**< Retorna o vetor de início das linhas.*/
+		const IndexVector &getColIndex() const; /**< Retorna o vetor de colunas.*/
+		const double *getValues() const; /**< Retorna o vetor de valores.*/
+		double *getValues(); /**< Retorna o vetor de valores, permitindo alteração.*/
+	};
+
+
+   /*************************************************************************
+    * Fornece uma identificação para os buffers de um Workspace.
+    *
+    * Cada algoritmo usa buffers próprios, de modo que um mesmo Workspace
+    * pode ser passado adiante sem que um algoritmo sobrescreva os dados de
+    * quem o chamou.
+    *************************************************************************/
+	enum workspaceSlot {
+		SOLVE_SLOT, /**< Vetor intermediário das substituições das fatorações.*/
+		UPDATE_SLOT, /**< Vetor de trabalho das atualizações de posto um.*/
+		MODIFICATION_SLOT, /**< Vetor de uma modificação de posto um do EquationSystem.*/
+		ROWS_SLOT, /**< Linhas não nulas de uma modificação de posto um.*/
+		CG_RESIDUAL_SLOT, /**< Resíduo do gradiente conjugado.*/
+		CG_PRECONDITIONED_SLOT, /**< Resíduo precondicionado do gradiente conjugado.*/
+		CG_DIRECTION_SLOT, /**< Direção de busca do gradiente conjugado.*/
+		CG_PRODUCT_SLOT, /**< Produto do operador pela direção de busca.*/
+		CG_RHS_SLOT, /**< Coluna do lado direito em solução.*/
+		CG_SOLUTION_SLOT, /**< Coluna da solução em iteração.*/
+		WORKSPACE_SLOTS /**< Número de buffers.*/
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe Workspace.
+    *
+    * Guarda os buffers de trabalho dos algoritmos do namespace NM. Cada 
+    * buffer só cresce: depois que um objeto resolveu um sistema de certa
+    * dimensão, as soluções seguintes de mesma dimensão não alocam memória.
+    * O conteúdo de um buffer não é preservado entre chamadas.
+    *************************************************************************/
+	class Workspace {
+	private:
+		std::vector<std::vector<unsigned char, AlignedAllocator<unsigned char>>> buffers; /**< Um buffer por workspaceSlot.*/
+
+	public:
+	   /*************************************************************************
+    	* Construtor da classe Workspace.
+    	*
+    	* Constrói os buffers vazios.
+    	*************************************************************************/
+		Workspace();
+
+	   /*************************************************************************
+    	* Reserva um buffer.
+    	*
+    	* @param slot Buffer desejado.
+    	* @param bytes Tamanho mínimo, em bytes.
+		*
+    	* @return Ponteiro alinhado para o início do buffer, válido até a próxima
+		* reserva do mesmo slot.
+    	*************************************************************************/
+		void *reserve(workspaceSlot slot, std::size_t bytes);
+
+	   /*************************************************************************
+    	* Reserva um buffer de n elementos do tipo T.
+    	*
+    	* @param slot Buffer desejado.
+    	* @param n Número de elementos.
+		*
+    	* @return Ponteiro para o primeiro elemento (não inicializado).
+    	*************************************************************************/
+		template <typename T>
+		T *get(workspaceSlot slot, std::size_t n) {
+			static_assert(std::is_trivial<T>::value, "Workspace guarda apenas tipos triviais");
+			return static_cast<T*>(reserve(slot, n * sizeof(T)));
+		}
+
+	   /*************************************************************************
+    	* Getter para a memória reservada.
+    	*
+    	* @return Soma das capacidades dos buffers, em bytes.
+    	*************************************************************************/
+		std::size_t getBytes() const;
+
+	   /*************************************************************************
+    	* Libera a memória de todos os buffers.
+    	*
+    	* @return Void.
+    	*************************************************************************/
+		void release();
+	};
+
+
+	//  A partir desta dimensão, LU e LDLt usam as fatorações blocadas: abaixo disso o
+	//painel ocupa quase toda a matriz e as multiplicações em paralelo não compensam.
+	constexpr unsigned int blockedThreshold = 256;
+
+
+   /*************************************************************************
+    * Declaração da classe LUDecomposition.
+    *
+    * Representa a fatoração LU com pivoteamento parcial de uma matriz
+    * quadrada, P*A = L*U. Os fatores L (com diagonal unitária implícita) e 
+    * U são armazenados no próprio buffer da matriz fatorada, com as linhas
+    * na ordem pivotada. A fatoração e as substituições são feitas pelo
+    * backend em uso (ver Backend.h).
+    *
+    * A fatoração e a solução são etapas separadas: uma vez fatorada, a
+    * matriz pode ser usada para resolver quantos sistemas forem necessários.
+    *************************************************************************/
+	class LUDecomposition {
+	private:
+		Matrix LU; /**< Fatores L e U, com as linhas na ordem pivotada.*/
+		std::vector<int> pivots; /**< Trocas de linhas da fatoração, na convenção do LAPACK.*/
+		std::vector<unsigned int> perm; /**< perm[k] é a linha da matriz original que ocupa a posição k.*/
+		bool factored; /**< Indica se a fatoração foi realizada.*/
+		bool singular; /**< Indica se algum pivô nulo foi encontrado.*/
+
+	public:
+	   /*************************************************************************
+    	* Construtor da classe LUDecomposition.
+    	*
+    	* Constrói um objeto ainda não fatorado.
+    	*************************************************************************/
+		LUDecomposition();
+
+
+	   /*************************************************************************
+    	* Construtor da classe LUDecomposition.
+    	*
+    	* Constrói o objeto e fatora a matriz a.
+    	*
+    	* @param a Matriz quadrada a ser fatorada.
+		*
+    	* @overload
+    	*************************************************************************/
+		explicit LUDecomposition(const Matrix &a);
+
+
+	   /*************************************************************************
+    	* Fatora uma matriz.
+    	*
+    	* Copia a matriz para o armazenamento interno e a fatora no próprio 
+		* buffer, com o getrf do backend em uso. Pivôs nulos não interrompem a
+		* fatoração: a coluna correspondente é ignorada e a incógnita associada
+		* recebe zero na solução, como no método de Gauss-Jordan usado 
+		* anteriormente.
+    	*
+    	* @param a Matriz quadrada a ser fatorada.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void factorize(const Matrix &a);
+
+
+	   /*************************************************************************
+    	* Fatora uma matriz no próprio buffer.
+    	*
+    	* Sobrescreve a com os fatores L e U e preenche perm com a permutação
+		* das linhas. As linhas são trocadas fisicamente: a linha k termina 
+		* com os fatores da linha original perm[k].
+    	*
+    	* @param a Visão da matriz quadrada a ser fatorada.
+    	* @param perm Vetor que recebe a permutação das linhas.
+		*
+    	* @return true se nenhum pivô nulo foi encontrado, false caso contrário.
+    	*************************************************************************/
+		static bool factorizeInPlace(MatrixView a, std::vector<unsigned int> &perm);
+
+
+	   /*************************************************************************
+    	* Fatora uma matriz no próprio buffer pelo algoritmo blocado.
+    	*
+    	* Produz os mesmos fatores e a mesma permutação de factorizeInPlace (a
+		* menos de arredondamento), mas atualiza o restante da matriz por 
+		* blocos, com multiplicações de matrizes distribuídas entre as threads
+		* de getThreadPool(). O resultado não depende do número de threads.
+    	*
+    	* @param a Visão da matriz quadrada a ser fatorada.
+    	* @param perm Vetor que recebe a permutação das linhas.
+		*
+    	* @return true se nenhum pivô nulo foi encontrado, false caso contrário.
+    	*************************************************************************/
+		static bool factorizeBlocked(MatrixView a, std::vector<unsigned int> &perm);
+
+
+	   /*************************************************************************
+    	* Resolve o sistema A*X = B a partir da fatoração.
+    	*
+    	* A matriz b é substituída pela solução. Cada coluna de b é tratada 
+		* como um lado direito independente.
+    	*
+    	* @param b Matriz dos lados direitos, sobrescrita pela solução.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void solve(Matrix &b) const;
+
+
+	   /*************************************************************************
+    	* Resolve o sistema A*X = B a partir da fatoração, sobre uma saída.
+    	*
+    	* A solução é escrita em x, redimensionada apenas se necessário; não há
+		* alocação se x já tiver as dimensões de b. b e x devem ser distintas.
+    	*
+    	* @param b Matriz dos lados direitos.
+    	* @param x Matriz que recebe a solução.
+		*
+    	* @return Void.
+		*
+		* @overload
+    	*************************************************************************/
+		void solve(const Matrix &b, Matrix &x) const;
+
+
+	   /*************************************************************************
+    	* Getter para o estado da fatoração.
+    	*
+    	* @return true se a matriz já foi fatorada.
+    	*************************************************************************/
+		bool isFactored() const;
+
+
+	   /*************************************************************************
+    	* Getter para a singularidade da matriz fatorada.
+    	*
+    	* @return true se algum pivô nulo foi encontrado durante a fatoração.
+    	*************************************************************************/
+		bool isSingular() const;
+
+
+	   /*************************************************************************
+    	* Getter para o vetor de permutação.
+    	*
+    	* @return Vetor cuja posição k contém a linha original pivotada para k.
+    	*************************************************************************/
+		const std::vector<unsigned int> &getPermutation() const;
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe SinglePrecisionLU.
+    *
+    * Fatoração LU com pivoteamento parcial calculada e armazenada em 
+    * precisão simples. Ocupa metade da memória da fatoração em precisão
+    * dupla e usa os micronúcleos de precisão simples da multiplicação 
+    * blocada, mas a solução tem apenas a precisão de um float: ela é
+    * usada como aproximação no refinamento iterativo da classe 
+    * EquationSystem.
+    *
+    * As linhas são trocadas fisicamente durante a fatoração: a linha k do
+    * fator corresponde à linha perm[k] da matriz original.
+    *************************************************************************/
+	class SinglePrecisionLU {
+	private:
+		std::vector<float> LU; /**< Fatores L e U, em ordem de linhas, na ordem pivotada.*/
+		unsigned int size; /**< Dimensão da matriz fatorada.*/
+		std::vector<unsigned int> perm; /**< perm[k] é a linha da matriz original que ocupa a posição k.*/
+		bool factored; /**< Indica se a fatoração foi realizada.*/
+		bool singular; /**< Indica se algum pivô nulo foi encontrado.*/
+
+	public:
+	   /*************************************************************************
+    	* Construtor da classe SinglePrecisionLU.
+    	*
+    	* Constrói um objeto ainda não fatorado.
+    	*************************************************************************/
+		SinglePrecisionLU();
+
+
+	   /*************************************************************************
+    	* Fatora uma matriz.
+    	*
+    	* Converte a matriz para precisão simples e a fatora pelo algoritmo
+		* blocado, em paralelo.
+    	*
+    	* @param a Matriz quadrada a ser fatorada.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void factorize(const Matrix &a);
+
+
+	   /*************************************************************************
+    	* Resolve o sistema A*X = B a partir da fatoração, em precisão simples.
+    	*
+    	* A matriz b é substituída pela solução aproximada. Pivôs nulos levam a
+		* incógnita correspondente a zero.
+    	*
+    	* @param b Matriz dos lados direitos, sobrescrita pela solução.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void solve(Matrix &b) const;
+
+
+		bool isFactored() const; /**< Retorna se a matriz já foi fatorada.*/
+		bool isSingular() const; /**< Retorna se algum pivô nulo foi encontrado.*/
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe CholeskyDecomposition.
+    *
+    * Representa a fatoração A = L*D*Lt de uma matriz simétrica positiva
+    * (semi)definida, em que L tem diagonal unitária e D é diagonal. Esta é
+    * a variante da fatoração de Cholesky que dispensa raízes quadradas.
+    * 
+    * Apenas o triângulo inferior da matriz é lido e escrito: L ocupa a
+    * parte estritamente inferior e D a diagonal. Não há pivoteamento, e o
+    * custo é metade do custo da fatoração LU.
+    *************************************************************************/
+	class CholeskyDecomposition {
+	private:
+		Matrix LD; /**< Fatores L (parte estritamente inferior) e D (diagonal).*/
+		bool factored; /**< Indica se a fatoração foi realizada com sucesso.*/
+		bool squareRoot; /**< Indica se LD guarda o fator de L*Lt calculado pelo potrf do backend.*/
+
+	   /*************************************************************************
+    	* Converte o fator de L*Lt para os fatores L e D, em O(n²).
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void splitDiagonal();
+
+	public:
+	   /*************************************************************************
+    	* Construtor da classe CholeskyDecomposition.
+    	*
+    	* Constrói um objeto ainda não fatorado.
+    	*************************************************************************/
+		CholeskyDecomposition();
+
+
+	   /*************************************************************************
+    	* Fatora uma matriz simétrica.
+    	*
+    	* Copia a matriz para o armazenamento interno e a fatora no próprio
+		* buffer. Pivôs nulos cuja coluna também é nula (malhas formadas apenas
+		* por fios, por exemplo) são ignorados e a incógnita correspondente 
+		* recebe zero na solução.
+		*
+		* Com um backend externo, a matriz é primeiro fatorada por potrf (e as
+		* soluções usam potrs); se ela não for positiva definida, a fatoração
+		* LDLt embutida é usada.
+    	*
+    	* @param a Matriz simétrica a ser fatorada.
+		*
+    	* @return true se a matriz é positiva (semi)definida e foi fatorada, 
+		* false caso contrário.
+    	*************************************************************************/
+		bool factorize(const Matrix &a);
+
+
+	   /*************************************************************************
+    	* Fatora uma matriz simétrica no próprio buffer.
+    	*
+    	* Sobrescreve o triângulo inferior de a com os fatores L e D. O 
+		* triângulo superior não é lido.
+    	*
+    	* @param a Visão da matriz simétrica a ser fatorada.
+		*
+    	* @return true se a matriz é positiva (semi)definida, false caso contrário.
+    	*************************************************************************/
+		static bool factorizeInPlace(MatrixView a);
+
+
+	   /*************************************************************************
+    	* Fatora uma matriz simétrica no próprio buffer pelo algoritmo blocado.
+    	*
+    	* Equivalente a factorizeInPlace (a menos de arredondamento), mas 
+		* atualiza o triângulo restante por blocos, com multiplicações de
+		* matrizes distribuídas entre as threads de getThreadPool(). O 
+		* resultado não depende do número de threads.
+    	*
+    	* @param a Visão da matriz simétrica a ser fatorada.
+		*
+    	* @return true se a matriz é positiva (semi)definida, false caso contrário.
+    	*************************************************************************/
+		static bool factorizeBlocked(MatrixView a);
+
+
+	   /*************************************************************************
+    	* Resolve o sistema A*X = B a partir da fatoração.
+    	*
+    	* A matriz b é substituída pela solução. Cada coluna de b é tratada 
+		* como um lado direito independente.
+    	*
+    	* @param b Matriz dos lados direitos, sobrescrita pela solução.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void solve(Matrix &b) const;
+
+	   /*************************************************************************
+    	* Atualiza a fatoração após uma modificação de posto um.
+    	*
+    	* Substitui a fatoração de A pela de A + alpha*v*vt sem refatorar, pelo
+		* método C1 de Gill, Golub, Murray e Saunders, em O(n²). Valores
+		* negativos de alpha realizam um downdate.
+    	*
+    	* @param v Vetor da modificação, com n elementos.
+    	* @param alpha Escala da modificação.
+		*
+    	* @return true se a fatoração foi atualizada. Se a atualização passar por
+		* um pivô nulo ou tornar um pivô não positivo, a fatoração é descartada
+		* e false é retornado.
+    	*************************************************************************/
+		bool update(std::vector<double> v, double alpha);
+
+
+	   /*************************************************************************
+    	* Atualiza a fatoração após uma modificação de posto um.
+    	*
+    	* Versão de update que usa o buffer UPDATE_SLOT de w em vez de uma 
+		* cópia de v.
+    	*
+    	* @param v Vetor da modificação, com n elementos.
+    	* @param alpha Escala da modificação.
+    	* @param w Memória de trabalho.
+		*
+    	* @return true se a fatoração foi atualizada.
+		*
+		* @overload
+    	*************************************************************************/
+		bool update(const double *v, double alpha, Workspace &w);
+
+
+	   /*************************************************************************
+    	* Getter para o estado da fatoração.
+    	*
+    	* @return true se a matriz foi fatorada com sucesso.
+    	*************************************************************************/
+		bool isFactored() const;
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe SparseCholesky.
+    *
+    * Representa a fatoração P*A*Pt = L*D*Lt de uma matriz esparsa simétrica
+    * positiva (semi)definida, em que P é uma permutação que reduz o 
+    * preenchimento (fill-in) de L.
+    *
+    * A fatoração é dividida em duas fases:
+    *  - análise simbólica (analyze): calcula a ordenação por grau mínimo 
+    *    aproximado, a árvore de eliminação e o número de entradas de cada 
+    *    coluna de L. Depende apenas do padrão de esparsidade de A.
+    *  - fatoração numérica (factorize): calcula L e D. Pode ser repetida
+    *    para qualquer matriz com o mesmo padrão, sem refazer a análise.
+    *************************************************************************/
+	class SparseCholesky {
+	private:
+		unsigned int size; /**< Dimensão da matriz analisada.*/
+		unsigned long long patternHash; /**< Assinatura do padrão de esparsidade analisado.*/
+		std::vector<unsigned int> perm; /**< perm[k] é a linha/coluna original eliminada na posição k.*/
+		std::vector<unsigned int> pinv; /**< Permutação inversa de perm.*/
+		std::vector<int> parent; /**< Árvore de eliminação (-1 indica raiz).*/
+		std::vector<unsigned int> Lp; /**< Início de cada coluna de L em Li e Lx.*/
+		std::vector<unsigned int> Li; /**< Linha de cada entrada de L.*/
+		std::vector<double> Lx; /**< Valor de cada entrada de L.*/
+		std::vector<double> D; /**< Diagonal D.*/
+		bool analyzed; /**< Indica se a análise simbólica foi realizada.*/
+		bool factored; /**< Indica se a fatoração numérica foi realizada com sucesso.*/
+
+	   /*************************************************************************
+    	* Calcula a assinatura do padrão de esparsidade de uma matriz.
     	*
-		* @return Matriz à esquerda.
-    	* @overload
+    	* @param a Matriz esparsa.
+		*
+    	* @return Assinatura (hash FNV-1a) de rowPtr e colIndex.
     	*************************************************************************/
-		Matrix operator- (Matrix &m1);
-		
+		static unsigned long long hashPattern(const SparseMatrix &a);
+
+	public:
 	   /*************************************************************************
-    	* Sobrecarga do operador -= da classe Matrix.
-    	*
-    	* Subtrai as entradas matriz à direita da matriz à esquerda e insere o 
-    	* resultado na matriz à esquerda.
+    	* Construtor da classe SparseCholesky.
     	*
-    	* @param &m1 referência à matriz à direita.
-    	* @overload
+    	* Constrói um objeto ainda não analisado.
     	*************************************************************************/
-		void operator-= (Matrix &m1);
+		SparseCholesky();
 
 
 	   /*************************************************************************
-    	* Sobrecarga do operador = da classe Matrix.
+    	* Calcula uma ordenação por grau mínimo aproximado.
     	*
-    	* Substitui as entradas da matriz à esquerda pelas entradas da matriz à direita.
+    	* Elimina, a cada passo, o vértice de menor grau aproximado do grafo
+		* de eliminação, representado como grafo quociente (variáveis e 
+		* elementos). O padrão usado é o de A + At, sem a diagonal.
     	*
-    	* @param &m1 referência à matriz que à direita.
-    	* @overload
+    	* @param a Matriz esparsa quadrada.
+    	* @param perm Vetor que recebe a ordem de eliminação.
+		*
+    	* @return Void.
     	*************************************************************************/
-		void operator= (const Matrix &m1);
-		
+		static void minimumDegreeOrdering(const SparseMatrix &a, std::vector<unsigned int> &perm);
+
 
 	   /*************************************************************************
-    	* Sobrecarga do operador [] da classe Matrix.
+    	* Análise simbólica.
     	*
-    	* Permite acesso direto aos valores presentes na matriz.
+    	* Calcula a ordenação, a árvore de eliminação e a estrutura de L. 
+		* Os valores de a não são utilizados.
     	*
-    	* @param index número da linha que será considerada.
+    	* @param a Matriz esparsa simétrica.
 		*
-    	* @return Linha do índice index.
-    	* @overload
+    	* @return Void.
     	*************************************************************************/
-		std::vector<double> &operator[] (unsigned int index);
-		
-
-       /*************************************************************************
-   		* Sobrecarga do operador - da classe Matrix.
-   		*
-   		* Multiplica todas as entradas da matriz à esquerda por -1 e retorna o 
-   		* resultado.
-   		*
-   		* @return Matriz com sinais invertidos.
-   		* @overload
-   		*************************************************************************/
-		Matrix operator-();
+		void analyze(const SparseMatrix &a);
 
 
 	   /*************************************************************************
-    	* Transpõe uma matriz.
+    	* Fatoração numérica.
     	*
-    	* Encontra a matriz transposta e retorna o resultado.
+    	* Calcula L e D para uma matriz com o mesmo padrão da matriz analisada.
+		* Pivôs nulos cuja coluna também é nula são ignorados e a incógnita 
+		* correspondente recebe zero na solução.
     	*
-    	* @return Matriz transposta.
-    	* @overload
+    	* @param a Matriz esparsa simétrica.
+		*
+    	* @return true se a matriz é positiva (semi)definida e foi fatorada, 
+		* false caso contrário.
     	*************************************************************************/
-		Matrix transpose();
+		bool factorize(const SparseMatrix &a);
+
 
 	   /*************************************************************************
-    	* Pega o "valor absoluto" de uma matriz.
+    	* Resolve o sistema A*X = B a partir da fatoração.
     	*
-    	* Faz com que todas as entradas da matriz se tornem positivas e retorna a
-    	* matriz resultante.
+    	* A matriz b é substituída pela solução. Cada coluna de b é tratada 
+		* como um lado direito independente.
     	*
-    	* @return Matriz em termos absolutos.
-    	* @overload
+    	* @param b Matriz dos lados direitos, sobrescrita pela solução.
+		*
+    	* @return Void.
     	*************************************************************************/
-		Matrix Abs();
+		void solve(Matrix &b) const;
 
 
 	   /*************************************************************************
-    	* Getter para uma coluna.
+    	* Resolve o sistema A*X = B a partir da fatoração.
     	*
-    	* Retorna um vector contendo as entradas de uma coluna da matriz.
+    	* Versão de solve que usa o buffer SOLVE_SLOT de w, sem alocações.
     	*
-    	* @param col índice da coluna.
-    	* @return Vector representando a coluna.
-    	* @overload
+    	* @param b Matriz dos lados direitos, sobrescrita pela solução.
+    	* @param w Memória de trabalho.
+		*
+    	* @return Void.
+		*
+		* @overload
     	*************************************************************************/
-		std::vector<double> getCol(unsigned int col);
+		void solve(Matrix &b, Workspace &w) const;
 
 	   /*************************************************************************
-    	* Getter para a quantidade de colunas da matriz.
+    	* Atualiza a fatoração após uma modificação de posto um.
     	*
-    	* Retorna a quantidade de colunas da matriz.
+    	* Substitui a fatoração de A pela de A + alpha*v*vt sem refatorar, pelo
+		* método C1 de Gill, Golub, Murray e Saunders restrito às colunas de L
+		* alcançadas por v na árvore de eliminação. O padrão de v*vt deve estar
+		* contido no padrão analisado. Valores negativos de alpha realizam um
+		* downdate.
     	*
-    	* @return Número de colunas.
-    	* @overload
+    	* @param v Vetor da modificação, com n elementos, na ordem original.
+    	* @param alpha Escala da modificação.
+		*
+    	* @return true se a fatoração foi atualizada. Se a atualização passar por
+		* um pivô nulo ou tornar um pivô não positivo, a fatoração é descartada
+		* e false é retornado.
     	*************************************************************************/
-		unsigned int getColNumber() const;
-		
+		bool update(const std::vector<double> &v, double alpha);
+
 
 	   /*************************************************************************
-    	* Getter para a quantidade de linhas da matriz.
+    	* Atualiza a fatoração após uma modificação de posto um.
     	*
-    	* Retorna a quantidade de linhas da matriz.
+    	* Versão de update que usa o buffer UPDATE_SLOT de w, sem alocações.
     	*
-    	* @return Número de cinhas.
-    	* @overload
+    	* @param v Vetor da modificação, com n elementos, na ordem original.
+    	* @param alpha Escala da modificação.
+    	* @param w Memória de trabalho.
+		*
+    	* @return true se a fatoração foi atualizada.
+		*
+		* @overload
     	*************************************************************************/
-		unsigned int getRowNumber() const;
-		
+		bool update(const double *v, double alpha, Workspace &w);
 
-		/*************************************************************************
-    	* Troca duas linhas.
+
+	   /*************************************************************************
+    	* Verifica se uma matriz tem o padrão de esparsidade analisado.
     	*
-    	* Dados dois índices representando duas linhas, troca as entradas dessas
-    	* duas linhas.
+    	* @param a Matriz esparsa.
 		*
-    	* @param l1 linha 1.
-    	* @param l2 linha 2.
-		*
-    	* @return Void.
-    	* @overload
+    	* @return true se a análise simbólica pode ser reaproveitada para a.
     	*************************************************************************/
-		void swapLines(double l1,double l2);
-	};	
-	
+		bool matchesPattern(const SparseMatrix &a) const;
+
+
+		bool isAnalyzed() const; /**< Retorna se a análise simbólica foi realizada.*/
+		bool isFactored() const; /**< Retorna se a fatoração numérica foi realizada com sucesso.*/
+		unsigned int getFactorNonZeros() const; /**< Retorna o número de entradas de L (fora da diagonal).*/
+		const std::vector<unsigned int> &getPermutation() const; /**< Retorna a ordem de eliminação.*/
+	};
+
+
+   /*************************************************************************
+    * Fornece uma identificação para os métodos de solução disponíveis na
+    * classe EquationSystem.
+    *************************************************************************/
+	enum solverMethod {
+		AUTOMATIC_SOLVER, /**< O método é escolhido conforme as propriedades do sistema.*/
+		GAUSS_SEIDEL_SOLVER, /**< Método iterativo de Gauss-Seidel.*/
+		LU_SOLVER, /**< Fatoração LU com pivoteamento parcial.*/
+		CHOLESKY_SOLVER, /**< Fatoração LDLt (densa ou esparsa).*/
+		CONJUGATE_GRADIENT_SOLVER, /**< Gradiente conjugado precondicionado.*/
+		MIXED_PRECISION_SOLVER /**< Fatoração LU em precisão simples com refinamento iterativo em precisão dupla.*/
+	};
+
+
+   /*************************************************************************
+    * Fornece uma identificação para os precondicionadores do método do
+    * gradiente conjugado.
+    *************************************************************************/
+	enum preconditionerType {
+		NO_PRECONDITIONER, /**< Sem precondicionamento.*/
+		JACOBI_PRECONDITIONER, /**< Precondicionador diagonal (Jacobi).*/
+		SSOR_PRECONDITIONER, /**< Sobre-relaxação sucessiva simétrica.*/
+		IC0_PRECONDITIONER /**< Fatoração de Cholesky incompleta sem preenchimento.*/
+	};
+
+
+   /*************************************************************************
+    * Declaração da estrutura SolverReport.
+    *
+    * Relatório da última solução de um sistema: método utilizado, número de
+    * iterações, resíduo final, tempo gasto, backend de álgebra linear e
+    * memória ocupada.
+    *************************************************************************/
+	struct SolverReport {
+		solverMethod method; /**< Método que produziu a solução.*/
+		unsigned int iterations; /**< Número de iterações (passos de refinamento na precisão mista; zero para métodos diretos).*/
+		double residual; /**< Norma do resíduo final, relativa à norma do vetor de constantes.*/
+		double time; /**< Tempo gasto na solução, em segundos.*/
+		bool converged; /**< Indica se a tolerância foi atingida.*/
+		const char *backend; /**< Nome do backend de álgebra linear em uso (ver Backend.h).*/
+		double factorizationTime; /**< Parte de time gasta em fatorações e análises simbólicas (zero se a fatoração em cache foi reaproveitada).*/
+		std::size_t bytes; /**< Memória mantida pelo solver (matrizes, fatoração em cache e buffers de trabalho), em bytes.*/
+	};
+
+
+	//  Maior dimensão resolvida por FixedMatrix no EquationSystem.
+	constexpr unsigned int maxFixedSize = 16;
+
+
    /*************************************************************************
     * Declaração da classe EquationSystem.
     *
@@ -241,14 +2099,38 @@ namespace NM {
 	private:
 
 		Matrix A;/**< Matriz dos coeficientes do sistema.*/
+		SparseMatrix S;/**< Matriz dos coeficientes do sistema, quando esparsa.*/
+		bool sparse;/**< Indica se o sistema foi construído com uma matriz esparsa.*/
 		Matrix B;/**< Matriz (vetor) das constantes do sistema.*/
 		Matrix x;/**< Matriz (vetor) solução do sistema.*/
+		LUDecomposition lu;/**< Fatoração LU da matriz dos coeficientes.*/
+		SinglePrecisionLU singleLU;/**< Fatoração LU em precisão simples da matriz dos coeficientes.*/
+		CholeskyDecomposition cholesky;/**< Fatoração LDLt da matriz dos coeficientes.*/
+		SparseCholesky sparseCholesky;/**< Fatoração LDLt esparsa da matriz dos coeficientes.*/
+		matrixStructure structure;/**< Estrutura da matriz dos coeficientes.*/
+		solverMethod method;/**< Método de solução escolhido.*/
+		preconditionerType preconditioner;/**< Precondicionador usado pelo gradiente conjugado.*/
+		SolverReport report;/**< Relatório da última solução.*/
+		bool factored;/**< Indica se há uma fatoração válida da matriz dos coeficientes em cache.*/
+		solverMethod factoredMethod;/**< Fatoração em cache (LU_SOLVER, CHOLESKY_SOLVER ou MIXED_PRECISION_SOLVER).*/
+		Matrix woodburyU;/**< Vetores das modificações aplicadas sobre a fatoração LU em cache.*/
+		Matrix woodburyZ;/**< A^-1 * woodburyU, com A a matriz da fatoração LU em cache.*/
+		std::vector<double> woodburySigma;/**< Escalas das modificações sobre a fatoração LU.*/
+		LUDecomposition woodburyK;/**< Fatoração da matriz de capacitância diag(1/sigma) + Ut*Z.*/
+		std::array<double, maxFixedSize * maxFixedSize> fixedFactor;/**< Fatores L e U de FixedMatrix dos sistemas com até maxFixedSize incógnitas, n x n por linhas.*/
+		std::array<unsigned int, maxFixedSize> fixedPerm;/**< Permutação das linhas de fixedFactor.*/
+		bool fixedFactored;/**< Indica se a fatoração LU em cache está em fixedFactor, e não em lu.*/
+		bool fixedSingular;/**< Indica se fixedFactor tem algum pivô nulo.*/
+		std::vector<double> diagonalScale;/**< Soma dos módulos das parcelas de cada elemento da diagonal desde a montagem, que limita o erro das modificações.*/
+		Workspace workspace;/**< Memória de trabalho das substituições e das atualizações.*/
 		
 	   /*************************************************************************
     	* Resolve o sistema pelo método de Gauss-Seidel.
     	*
     	* Encontra a solução aproximada iterativamente pelo método de Gauss-Seidel
-    	* assumindo uma tolerância e um número máximo de iterações.
+    	* assumindo uma tolerância e um número máximo de iterações. As 
+		* incógnitas são relaxadas por cores, em paralelo, com fator de
+		* sobre-relaxação adaptativo (ver MulticolorSOR).
     	*
     	* @param tol Tolerância.
     	* @param maxIter Número máximo de iterações.
@@ -260,44 +2142,154 @@ namespace NM {
 
 
 	   /*******************************************************************************
-    	* Checa se o sistema obedece ao critério de Sassenfeld.
+    	* Escolhe o método do modo automático.
     	*
-    	* Aplica o critério de Sassenfeld ao sistema. Retorna verdadeiro se o
-    	* método de Gauss-Seidel converge para uma solução e falso caso contrário.  
+    	* Consulta o planejador global (ver Planner.h): usa o método lembrado
+		* para a topologia da matriz ou, se não houver um, o mais barato pelo
+		* modelo de custo. Com a calibração ativada, mede os candidatos e
+		* lembra o mais rápido.
     	*
-    	* @return Se o sistema satisfaz o crítério de Sassenfield retorna 1, caso
-		* contrário, retorna 0.
+    	* @param tol Tolerância.
+    	* @param maxIter Número máximo de iterações.
+		*
+    	* @return Método escolhido.
+    	******************************************************************************/
+		solverMethod planMethod(double tol, unsigned int maxIter);
+
+
+	   /*******************************************************************************
+    	* Resolve o sistema por um método específico.
     	*
-		* @overload
+    	* @param m Método de solução (diferente de AUTOMATIC_SOLVER).
+    	* @param tol Tolerância.
+    	* @param maxIter Número máximo de iterações.
+		*
+    	* @return false se o método não se aplica ao sistema ou, no modo
+		* automático, se um método iterativo não convergiu.
     	******************************************************************************/
-		bool sassenfeldCriteria();		
+		bool solveWith(solverMethod m, double tol, unsigned int maxIter);
 	
 
-	   /*************************************************************************
-    	* Realiza o pivoteamento parcial do sistema.
+
+	   /******************************************************************************
+    	* Resolve o sistema pela fatoração LU.
     	*
-    	* Procura o maior dentre os elementos da coluna, começando por um índice
-    	* inicial. Se existir, são trocadas as linhas do índice inicial e do 
-    	* índice cujo elemento é o maior. 
+    	* Encontra a solução exata do sistema através da fatoração LU com 
+		* pivoteamento parcial. A fatoração só é calculada se não houver uma
+		* em cache.
     	*
-    	* @param startI Índice inicial.
-    	* 
-		* @return Void.
+    	* @return Void.
+        *
     	* @overload
-    	*************************************************************************/
-		void findPivot(unsigned int startI);	
-				
+    	*******************************************************************************/
+		void luSolve();
+
 
 	   /******************************************************************************
-    	* Resolve o sistema pelo método de Gauss-Jordan.
+    	* Resolve o sistema por refinamento iterativo em precisão mista.
     	*
-    	* Encontra a solução exata do sistema através do método de Gauss-Jordan.
+    	* Fatora a matriz dos coeficientes em precisão simples (se não houver
+		* uma fatoração em cache) e refina a solução com resíduos calculados em
+		* precisão dupla sobre a matriz original, até que o erro regressivo 
+		* atinja a precisão dupla. Se o refinamento estagnar, ou se a fatoração
+		* em precisão simples for singular, o sistema é resolvido pela fatoração
+		* LU em precisão dupla.
     	*
     	* @return Void.
-        *
-    	* @overload
     	*******************************************************************************/
-		void gaussJordan();
+		void mixedPrecisionSolve();
+
+
+	   /******************************************************************************
+    	* Aplica uma modificação de posto um sobre a fatoração LU em cache.
+    	*
+    	* A modificação é acumulada na fórmula de Sherman-Morrison-Woodbury, 
+		* A'^-1 = A^-1 - Z*K^-1*Ut*A^-1, e corrigida a cada solução.
+    	*
+    	* @param u Vetor da modificação.
+    	* @param sigma Escala da modificação.
+		*
+    	* @return true se a modificação foi acumulada, false se a fatoração deve
+		* ser refeita.
+    	*******************************************************************************/
+		bool woodburyUpdate(const double *u, double sigma);
+
+
+	   /******************************************************************************
+    	* Fatora a matriz dos coeficientes por FixedMatrix.
+    	*
+    	* Usada nos sistemas com até maxFixedSize incógnitas. Os fatores e a
+		* permutação são guardados em fixedFactor e fixedPerm, e passam a ser a
+		* fatoração LU em cache.
+    	*
+    	* @return Void.
+    	*******************************************************************************/
+		void fixedFactorize();
+
+
+	   /******************************************************************************
+    	* Resolve o sistema pela fatoração em fixedFactor.
+    	*
+    	* @return Void.
+    	*******************************************************************************/
+		void fixedSolve();
+
+
+	   /******************************************************************************
+    	* Resolve o sistema pela fatoração LDLt.
+    	*
+    	* Tenta fatorar a matriz dos coeficientes como simétrica positiva 
+		* (semi)definida e, em caso de sucesso, encontra a solução exata. A
+		* fatoração só é calculada se não houver uma em cache.
+    	*
+    	* @return true se a fatoração foi possível, false caso contrário.
+    	*******************************************************************************/
+		bool choleskySolve();
+
+
+	   /******************************************************************************
+    	* Resolve o sistema pela fatoração LDLt esparsa.
+    	*
+    	* Realiza a análise simbólica, caso ainda não tenha sido feita para o
+		* padrão atual, e a fatoração numérica da matriz esparsa, caso não haja
+		* uma em cache.
+    	*
+    	* @return true se a fatoração foi possível, false caso contrário.
+    	*******************************************************************************/
+		bool sparseCholeskySolve();
+
+
+	   /******************************************************************************
+    	* Resolve o sistema pelo método do gradiente conjugado precondicionado.
+    	*
+    	* Válido para sistemas simétricos positivos definidos. A solução parte
+		* do valor atual de x.
+    	*
+    	* @param tol Tolerância para o resíduo relativo.
+    	* @param maxIter Número máximo de iterações.
+		*
+    	* @return true se a tolerância foi atingida, false caso contrário.
+    	*******************************************************************************/
+		bool conjugateGradientSolve(double tol, unsigned int maxIter);
+
+
+	   /******************************************************************************
+    	* Calcula o resíduo relativo da solução atual.
+    	*
+    	* @return Norma de B - A*x dividida pela norma de B.
+    	*******************************************************************************/
+		double relativeResidual() const;
+
+
+	   /******************************************************************************
+    	* Resolve o sistema, deixando a solução em x.
+    	*
+    	* @param tol Tolerância para o erro aproximado.
+    	* @param maxIter Número máximo de iterações.
+		*
+    	* @return Void.
+    	*******************************************************************************/
+		void computeSolution(double tol, unsigned int maxIter);
 
 	public:
 
@@ -305,12 +2297,104 @@ namespace NM {
         * Construtor da classe EquationSystem.
 	    * 
         * Constrói um sistema de equações baseado numa matriz de coeficientes e 
-        * outra de constantes.
+        * outra de constantes. Cada coluna de b é um lado direito independente.
     	* 
     	* @param a Matriz dos coeficientes.
     	* @param b Matriz das constantes.
+    	* @param s Estrutura conhecida da matriz dos coeficientes.
+    	***************************************************************************/
+		EquationSystem(Matrix a, Matrix b, matrixStructure s = UNKNOWN_STRUCTURE);
+
+
+	   /***************************************************************************
+        * Construtor da classe EquationSystem.
+	    * 
+        * Constrói um sistema de equações cuja matriz dos coeficientes é 
+		* esparsa. Sistemas simétricos são resolvidos pela fatoração esparsa;
+		* os demais são convertidos para a forma densa.
+    	* 
+    	* @param a Matriz esparsa dos coeficientes.
+    	* @param b Matriz das constantes.
+    	* @param s Estrutura conhecida da matriz dos coeficientes.
+		*
+		* @overload
+    	***************************************************************************/
+		EquationSystem(SparseMatrix a, Matrix b, matrixStructure s = UNKNOWN_STRUCTURE);
+
+
+	   /***************************************************************************
+        * Substitui os valores da matriz esparsa dos coeficientes.
+	    * 
+        * Descarta a fatoração em cache. Se a nova matriz tem o mesmo padrão de
+		* esparsidade, a análise simbólica já realizada é reaproveitada na
+		* próxima solução. A estrutura da matriz anterior não é herdada: sem s,
+		* a simetria é verificada novamente.
+    	* 
+    	* @param a Nova matriz esparsa dos coeficientes.
+    	* @param s Estrutura conhecida da nova matriz.
+		*
+		* @return Void.
+    	***************************************************************************/
+		void setCoefficients(SparseMatrix a, matrixStructure s = UNKNOWN_STRUCTURE);
+
+
+	   /***************************************************************************
+        * Substitui a matriz das constantes.
+	    * 
+        * A fatoração em cache é mantida: a próxima solução realiza apenas as
+		* substituições, em O(n²) no caso denso. A solução anterior é mantida
+		* como chute inicial dos métodos iterativos quando as dimensões coincidem.
+    	* 
+    	* @param b Nova matriz das constantes, com um lado direito por coluna.
+		*
+		* @return Void.
     	***************************************************************************/
-		EquationSystem(Matrix a, Matrix b);
+		void setConstants(const Matrix &b);
+
+
+	   /***************************************************************************
+        * Aplica uma modificação de posto k à matriz dos coeficientes.
+	    * 
+        * Substitui A por A + W*diag(sigma)*Wt. Uma fatoração LDLt em cache é 
+		* atualizada coluna a coluna em O(n²) (ou menos, no caso esparso); uma
+		* fatoração LU em cache é corrigida pela fórmula de Sherman-Morrison-
+		* Woodbury. Se não for possível atualizar a fatoração (LU singular,
+		* posto acumulado grande demais, pivô do LDLt anulado) ou se a
+		* modificação cancelar um elemento da diagonal, a fatoração é refeita na
+		* próxima solução. Entradas canceladas até o nível do arredondamento são
+		* zeradas, como na montagem direta.
+    	* 
+    	* @param W Matriz n x k com os vetores da modificação.
+    	* @param sigma Escala de cada coluna de W.
+		*
+		* @return true se a fatoração em cache foi atualizada, false caso
+		* contrário.
+    	***************************************************************************/
+		bool updateCoefficients(const Matrix &W, const std::vector<double> &sigma);
+
+
+	   /***************************************************************************
+        * Escolhe o método de solução.
+	    * 
+        * No modo automático, o método é escolhido pelo modelo de custo de
+		* SolverPlanner (dimensão, esparsidade, simetria, dominância diagonal e
+		* condicionamento), com calibração opcional na primeira solução. Se o
+		* método escolhido falhar, o sistema recorre à fatoração LU.
+    	* 
+    	* @param m Método de solução.
+    	* @param p Precondicionador usado pelo gradiente conjugado.
+		*
+		* @return Void.
+    	***************************************************************************/
+		void setMethod(solverMethod m, preconditionerType p = IC0_PRECONDITIONER);
+
+
+	   /***************************************************************************
+        * Getter para o relatório da última solução.
+	    * 
+        * @return Método, iterações, resíduo e tempo da última solução.
+    	***************************************************************************/
+		SolverReport getReport() const;
 
 
 		/*************************************************************************
@@ -321,8 +2405,77 @@ namespace NM {
     	* 
     	* @param tol Tolerância para o erro aproximado.
     	* @param maxIter Número máximo de iterações.
+		*
+		* @return Matriz solução, com uma coluna por lado direito.
     	*************************************************************************/
 		Matrix getSolution(double tol, unsigned int maxIter);
+
+
+		/*************************************************************************
+        * Resolve o sistema e escreve a solução em uma matriz existente.
+	    * 
+        * Não aloca memória para a saída se ela já tiver as dimensões da 
+		* solução. Com uma fatoração em cache, a solução inteira é feita sem
+		* alocações.
+    	* 
+    	* @param out Matriz que recebe a solução.
+    	* @param tol Tolerância para o erro aproximado.
+    	* @param maxIter Número máximo de iterações.
+		*
+		* @return Void.
+		*
+		* @overload
+    	*************************************************************************/
+		void getSolution(Matrix &out, double tol, unsigned int maxIter);
+
+
+		/*************************************************************************
+        * Resolve o sistema para novos lados direitos.
+	    * 
+        * Equivale a setConstants(b) seguido de getSolution(tol, maxIter),
+		* reaproveitando a fatoração em cache.
+    	* 
+    	* @param b Matriz das constantes, com um lado direito por coluna.
+    	* @param tol Tolerância para o erro aproximado.
+    	* @param maxIter Número máximo de iterações.
+		*
+		* @return Matriz solução, com uma coluna por lado direito.
+    	*************************************************************************/
+		Matrix solve(const Matrix &b, double tol, unsigned int maxIter);
+
+
+		/*************************************************************************
+        * Resolve o sistema para novos lados direitos, sobre uma saída.
+	    * 
+        * Equivale a setConstants(b) seguido de getSolution(out, tol, maxIter).
+    	* 
+    	* @param b Matriz das constantes, com um lado direito por coluna.
+    	* @param out Matriz que recebe a solução.
+    	* @param tol Tolerância para o erro aproximado.
+    	* @param maxIter Número máximo de iterações.
+		*
+		* @return Void.
+		*
+		* @overload
+    	*************************************************************************/
+		void solve(const Matrix &b, Matrix &out, double tol, unsigned int maxIter);
+
+
+	   /***************************************************************************
+        * Verifica se há uma fatoração em cache.
+	    * 
+        * @return true se a próxima solução reaproveitará uma fatoração.
+    	***************************************************************************/
+		bool isFactored() const;
+
+
+	   /***************************************************************************
+        * Getter para a memória mantida pelo sistema.
+	    * 
+        * @return Bytes das matrizes do sistema, da fatoração em cache e dos
+		* buffers de trabalho.
+    	***************************************************************************/
+		std::size_t getBytes() const;
 	};
 }
 
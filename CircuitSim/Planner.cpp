@@ -0,0 +1,242 @@
+/********************************************************************************************
+ * @file Planner.cpp
+ * @authors: Lucas Carvalho; Rafael Marasca Martins
+ * @date: 18 10 2026
+ * @brief Implementação da classe SolverPlanner.
+ *
+ * Este arquivo contém a análise das matrizes, o modelo de custo dos métodos de solução e a
+ * memória dos métodos calibrados.
+ *
+ ********************************************************************************************/
+
+#include "Planner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace NM {
+
+	//  Número máximo de topologias lembradas; ao atingi-lo, a memória é esvaziada.
+	static const std::size_t maxRememberedTopologies = 1024;
+
+	//  Assinatura FNV-1a, acumulada valor a valor.
+	static void hashValue(unsigned long long &h, unsigned long long v) {
+		h = (h ^ v) * 1099511628211ULL;
+	}
+
+	//  Completa as propriedades a partir das somas de cada linha: d é a diagonal, r a soma
+	//dos módulos fora da diagonal e beta o coeficiente de Sassenfeld.
+	struct RowSummary {
+		double upper = 0; /**< Maior |d| + r (limite superior dos autovalores).*/
+		double lower = std::numeric_limits<double>::infinity(); /**< Menor |d| - r.*/
+		double minDiagonal = std::numeric_limits<double>::infinity(); /**< Menor |d|.*/
+
+		void add(double d, double r) {
+			upper = std::max(upper, std::fabs(d) + r);
+			lower = std::min(lower, std::fabs(d) - r);
+			minDiagonal = std::min(minDiagonal, std::fabs(d));
+		}
+
+		//  Com dominância diagonal estrita, os círculos de Gershgorin limitam os autovalores
+		//longe de zero. Sem ela, a estimativa supõe uma matriz do tipo Laplaciano, cuja
+		//condição cresce com a dimensão.
+		double condition(unsigned int n) const {
+			if(n == 0)
+				return 1;
+			if(minDiagonal == 0)
+				return std::numeric_limits<double>::infinity();
+			if(lower > 0)
+				return upper / lower;
+			return n * upper / minDiagonal;
+		}
+	};
+
+	SolverPlanner::SolverPlanner() : calibration(false), candidates(3) {}
+
+	MatrixProperties SolverPlanner::analyze(const Matrix &a, matrixStructure s) {
+		const unsigned int n = a.getRowNumber(), m = a.getColNumber();
+		MatrixProperties p = {n, 0, false, false, n == m, 0, 0, 14695981039346656037ULL};
+		p.symmetric = (n == m) and (s == UNKNOWN_STRUCTURE ? a.isSymmetric() : s == SYMMETRIC);
+
+		hashValue(p.topology, n);
+		hashValue(p.topology, m);
+
+		std::vector<double> beta(n, 0);
+		RowSummary rows;
+		for(unsigned int i = 0; i < n; i++) {
+			double before = 0, after = 0;
+			for(unsigned int j = 0; j < m; j++) {
+				const double v = a(i, j);
+				if(v == 0)
+					continue;
+				p.nonZeros++;
+				hashValue(p.topology, j);
+				if(j < i)
+					before += std::fabs(v) * beta[j];
+				if(j > i)
+					after += std::fabs(v);
+			}
+			hashValue(p.topology, p.nonZeros);
+
+			if(n != m)
+				continue;
+			double r = -std::fabs(a(i, i));
+			for(unsigned int j = 0; j < m; j++)
+				r += std::fabs(a(i, j));
+
+			const double d = a(i, i);
+			p.positiveDiagonal = p.positiveDiagonal and d > 0;
+			beta[i] = (d == 0) ? std::numeric_limits<double>::infinity() : (before + after) / std::fabs(d);
+			p.sassenfeld = std::max(p.sassenfeld, beta[i]);
+			rows.add(d, r);
+		}
+
+		p.conditionEstimate = (n == m) ? rows.condition(n) : std::numeric_limits<double>::infinity();
+		if(n != m)
+			p.sassenfeld = std::numeric_limits<double>::infinity();
+		return p;
+	}
+
+	MatrixProperties SolverPlanner::analyze(const SparseMatrix &a, matrixStructure s) {
+		const unsigned int n = a.getRowNumber(), m = a.getColNumber();
+		MatrixProperties p = {n, a.getNonZeros(), true, false, n == m, 0, 0, 14695981039346656037ULL};
+		p.symmetric = (n == m) and (s == UNKNOWN_STRUCTURE ? a.isSymmetric() : s == SYMMETRIC);
+
+		const IndexVector &rp = a.getRowPtr();
+		const IndexVector &ci = a.getColIndex();
+		const double *values = a.getValues();
+
+		hashValue(p.topology, n);
+		hashValue(p.topology, m);
+		for(std::size_t k = 0; k < rp.size(); k++)
+			hashValue(p.topology, rp[k]);
+		for(std::size_t k = 0; k < ci.size(); k++)
+			hashValue(p.topology, ci[k]);
+
+		if(n != m) {
+			p.sassenfeld = p.conditionEstimate = std::numeric_limits<double>::infinity();
+			return p;
+		}
+
+		std::vector<double> beta(n, 0);
+		RowSummary rows;
+		for(unsigned int i = 0; i < n; i++) {
+			double d = 0, r = 0, before = 0, after = 0;
+			for(unsigned int k = rp[i]; k < rp[i + 1]; k++) {
+				const double v = values[k];
+				if(ci[k] == i)
+					d = v;
+				else {
+					r += std::fabs(v);
+					if(ci[k] < i)
+						before += std::fabs(v) * beta[ci[k]];
+					else
+						after += std::fabs(v);
+				}
+			}
+
+			p.positiveDiagonal = p.positiveDiagonal and d > 0;
+			beta[i] = (d == 0) ? std::numeric_limits<double>::infinity() : (before + after) / std::fabs(d);
+			p.sassenfeld = std::max(p.sassenfeld, beta[i]);
+			rows.add(d, r);
+		}
+
+		p.conditionEstimate = rows.condition(n);
+		return p;
+	}
+
+	//  Custos em operações de ponto flutuante, incluindo a solução. "work" é o custo de um
+	//produto pela matriz na forma em que ela está armazenada.
+	std::vector<SolverPlan> SolverPlanner::rank(const MatrixProperties &p, double tol) const {
+		const double n = p.size;
+		const double nnz = std::max(double(p.nonZeros), n);
+		const double work = 2 * (p.sparse ? nnz : n * n);
+		const double densify = p.sparse ? n * n : 0;
+		const double floatEpsilon = std::numeric_limits<float>::epsilon();
+		const double doubleEpsilon = std::numeric_limits<double>::epsilon();
+		const double kappa = p.conditionEstimate;
+		tol = std::max(tol, doubleEpsilon);
+
+		std::vector<SolverPlan> plans;
+		plans.push_back({LU_SOLVER, 2.0 / 3.0 * n * n * n + 2 * n * n + densify});
+
+		//  Precisão mista: a fatoração em float custa metade, e cada passo de refinamento
+		//ganha -log(kappa*eps(float)) dígitos.
+		if(kappa * floatEpsilon < 0.5) {
+			const double steps = std::ceil(std::log(doubleEpsilon) / std::log(std::max(kappa * floatEpsilon, floatEpsilon)));
+			plans.push_back({MIXED_PRECISION_SOLVER, 1.0 / 3.0 * n * n * n + (steps + 1) * 4 * n * n + densify});
+		}
+
+		if(p.symmetric and p.positiveDiagonal) {
+			//  Na forma esparsa, o preenchimento de L com a ordenação de grau mínimo é estimado
+			//em nnz*log2(n) (típico de grafos planares, como os de circuitos); o custo da
+			//fatoração é a soma dos quadrados das colunas de L, ~ nnz(L)²/n.
+			if(p.sparse) {
+				const double fill = std::min(nnz * std::log2(n + 1), n * (n + 1) / 2);
+				plans.push_back({CHOLESKY_SOLVER, fill * fill / std::max(n, 1.0) + 4 * fill + 10 * nnz});
+			}
+			else
+				plans.push_back({CHOLESKY_SOLVER, 1.0 / 3.0 * n * n * n + 2 * n * n});
+
+			//  Gradiente conjugado: ~sqrt(kappa)*ln(2/tol)/2 iterações (no máximo n, em
+			//aritmética exata), cada uma com um produto, o precondicionador e cinco
+			//operações vetoriais.
+			if(std::isfinite(kappa)) {
+				const double iterations = std::min(n, std::ceil(0.5 * std::sqrt(kappa) * std::log(2 / tol)));
+				plans.push_back({CONJUGATE_GRADIENT_SOLVER, iterations * (work + 2 * nnz + 10 * n) + nnz * nnz / std::max(n, 1.0)});
+			}
+		}
+
+		//  Gauss-Seidel só é candidato se o critério de Sassenfeld garante a convergência.
+		if(p.sassenfeld < 1) {
+			const double iterations = (p.sassenfeld == 0) ? 1 : std::ceil(std::log(tol) / std::log(p.sassenfeld));
+			plans.push_back({GAUSS_SEIDEL_SOLVER, iterations * (work + n) + nnz});
+		}
+
+		std::stable_sort(plans.begin(), plans.end(), [](const SolverPlan &a, const SolverPlan &b) { return a.cost < b.cost; });
+		return plans;
+	}
+
+	bool SolverPlanner::lookup(unsigned long long topology, solverMethod &m) const {
+		std::lock_guard<std::mutex> lock(mutex);
+		const std::unordered_map<unsigned long long, solverMethod>::const_iterator it = winners.find(topology);
+		if(it == winners.end())
+			return false;
+		m = it->second;
+		return true;
+	}
+
+	void SolverPlanner::record(unsigned long long topology, solverMethod m) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if(winners.size() >= maxRememberedTopologies)
+			winners.clear();
+		winners[topology] = m;
+	}
+
+	void SolverPlanner::clear() {
+		std::lock_guard<std::mutex> lock(mutex);
+		winners.clear();
+	}
+
+	void SolverPlanner::setCalibration(bool enabled, unsigned int n) {
+		std::lock_guard<std::mutex> lock(mutex);
+		calibration = enabled;
+		candidates = std::max(n, 1u);
+	}
+
+	bool SolverPlanner::isCalibrationEnabled() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return calibration;
+	}
+
+	unsigned int SolverPlanner::getCandidateCount() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return candidates;
+	}
+
+	SolverPlanner &getSolverPlanner() {
+		static SolverPlanner planner;
+		return planner;
+	}
+}
@@ -0,0 +1,168 @@
+/********************************************************************************************
+ * @file Planner.h
+ * @authors: Lucas Carvalho; Rafael Marasca Martins
+ * @date: 18 10 2026
+ * @brief Declaração da classe SolverPlanner.
+ *
+ * Este arquivo contém a escolha automática do método de solução da classe EquationSystem:
+ * a análise das propriedades da matriz dos coeficientes, o modelo de custo de cada método
+ * e a calibração opcional, que mede os candidatos na primeira solução de cada topologia.
+ *
+ ********************************************************************************************/
+
+#ifndef PLANNER_H
+#define PLANNER_H
+
+#include "Numeric.h"
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace NM {
+
+   /*************************************************************************
+    * Declaração da estrutura MatrixProperties.
+    *
+    * Propriedades da matriz dos coeficientes usadas pelo modelo de custo.
+    * Todas são obtidas em uma passada sobre as entradas da matriz.
+    *************************************************************************/
+	struct MatrixProperties {
+		unsigned int size; /**< Dimensão da matriz.*/
+		std::size_t nonZeros; /**< Número de entradas não nulas.*/
+		bool sparse; /**< Indica se a matriz está armazenada na forma esparsa.*/
+		bool symmetric; /**< Indica se a matriz é simétrica.*/
+		bool positiveDiagonal; /**< Indica se todos os elementos da diagonal são positivos (necessário para uma matriz positiva definida).*/
+		double sassenfeld; /**< Maior coeficiente de Sassenfeld: abaixo de 1, Gauss-Seidel converge, com o erro reduzido ao menos por este fator a cada iteração.*/
+		double conditionEstimate; /**< Estimativa grosseira do número de condição, pelos círculos de Gershgorin.*/
+		unsigned long long topology; /**< Assinatura das dimensões e do padrão de entradas não nulas.*/
+	};
+
+
+   /*************************************************************************
+    * Declaração da estrutura SolverPlan.
+    *
+    * Um método candidato e seu custo estimado.
+    *************************************************************************/
+	struct SolverPlan {
+		solverMethod method; /**< Método de solução.*/
+		double cost; /**< Custo estimado da primeira solução, em operações de ponto flutuante.*/
+	};
+
+
+   /*************************************************************************
+    * Declaração da classe SolverPlanner.
+    *
+    * Escolhe o método de solução do modo automático de EquationSystem. Os
+    * métodos aplicáveis à matriz são ordenados por um modelo de custo que
+    * considera dimensão, esparsidade, simetria, dominância diagonal e
+    * condicionamento.
+    *
+    * Com a calibração ativada, a primeira solução de cada topologia mede o
+    * tempo dos candidatos mais baratos pelo modelo, e o mais rápido é
+    * lembrado para as soluções seguintes de matrizes com a mesma topologia.
+    *************************************************************************/
+	class SolverPlanner {
+	private:
+		mutable std::mutex mutex; /**< Protege os métodos lembrados.*/
+		std::unordered_map<unsigned long long, solverMethod> winners; /**< Método mais rápido de cada topologia calibrada.*/
+		bool calibration; /**< Indica se a calibração está ativada.*/
+		unsigned int candidates; /**< Número de candidatos medidos na calibração.*/
+
+	public:
+	   /*************************************************************************
+    	* Construtor da classe SolverPlanner.
+    	*
+    	* Constrói o planejador com a calibração desativada.
+    	*************************************************************************/
+		SolverPlanner();
+
+		SolverPlanner(const SolverPlanner &) = delete;
+		SolverPlanner &operator=(const SolverPlanner &) = delete;
+
+	   /*************************************************************************
+    	* Analisa uma matriz densa.
+    	*
+    	* @param a Matriz dos coeficientes.
+    	* @param s Estrutura conhecida da matriz (a simetria só é verificada se
+		* for UNKNOWN_STRUCTURE).
+		*
+    	* @return Propriedades da matriz.
+    	*************************************************************************/
+		static MatrixProperties analyze(const Matrix &a, matrixStructure s);
+
+	   /*************************************************************************
+    	* Analisa uma matriz esparsa.
+    	*
+    	* @param a Matriz dos coeficientes.
+    	* @param s Estrutura conhecida da matriz.
+		*
+    	* @return Propriedades da matriz.
+		*
+		* @overload
+    	*************************************************************************/
+		static MatrixProperties analyze(const SparseMatrix &a, matrixStructure s);
+
+	   /*************************************************************************
+    	* Ordena os métodos aplicáveis pelo custo estimado.
+    	*
+    	* @param p Propriedades da matriz.
+    	* @param tol Tolerância pedida aos métodos iterativos.
+		*
+    	* @return Candidatos, do mais barato ao mais caro. A fatoração LU, que
+		* se aplica a qualquer matriz quadrada, está sempre entre eles.
+    	*************************************************************************/
+		std::vector<SolverPlan> rank(const MatrixProperties &p, double tol) const;
+
+	   /*************************************************************************
+    	* Consulta o método lembrado para uma topologia.
+    	*
+    	* @param topology Assinatura da topologia.
+    	* @param m Recebe o método, se houver um.
+		*
+    	* @return true se a topologia já foi calibrada.
+    	*************************************************************************/
+		bool lookup(unsigned long long topology, solverMethod &m) const;
+
+	   /*************************************************************************
+    	* Lembra o método mais rápido de uma topologia.
+    	*
+    	* @param topology Assinatura da topologia.
+    	* @param m Método vencedor da calibração.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void record(unsigned long long topology, solverMethod m);
+
+	   /*************************************************************************
+    	* Esquece todos os métodos lembrados.
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void clear();
+
+	   /*************************************************************************
+    	* Ativa ou desativa a calibração.
+    	*
+    	* @param enabled Indica se a calibração deve ser feita.
+    	* @param n Número de candidatos medidos (os n mais baratos pelo modelo).
+		*
+    	* @return Void.
+    	*************************************************************************/
+		void setCalibration(bool enabled, unsigned int n = 3);
+
+		bool isCalibrationEnabled() const; /**< Retorna se a calibração está ativada.*/
+		unsigned int getCandidateCount() const; /**< Retorna o número de candidatos medidos na calibração.*/
+	};
+
+
+   /*************************************************************************
+    * Getter para o planejador global do namespace NM.
+    *
+    * @return Planejador compartilhado pelos objetos EquationSystem.
+    *************************************************************************/
+	SolverPlanner &getSolverPlanner();
+}
+
+#endif
@@ -0,0 +1,148 @@
+/********************************************************************************************
+ * @file ThreadPool.cpp
+ * @authors: Lucas Carvalho; Rafael Marasca Martins
+ * @date: 18 10 2026
+ * @brief Implementação da classe ThreadPool.
+ *
+ * Este arquivo contém as implementações dos métodos da classe ThreadPool e do conjunto de
+ * threads global.
+ *
+ ********************************************************************************************/
+
+#include "ThreadPool.h"
+
+#include <memory>
+
+namespace NM {
+
+	//  Marca as threads que estão executando tarefas, para que laços aninhados não esperem
+	//pelo próprio conjunto.
+	static thread_local bool insideTask = false;
+
+	ThreadPool::ThreadPool(unsigned int threads)
+		: task(nullptr), taskCount(0), next(0), finished(0), active(0), generation(0), stopping(false) {
+		for(unsigned int i = 1; i < threads; i++)
+			workers.emplace_back(&ThreadPool::workerLoop, this);
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for(std::thread &t : workers)
+			t.join();
+	}
+
+	unsigned int ThreadPool::getThreadCount() const { return workers.size() + 1; }
+
+	void ThreadPool::workerLoop() {
+		unsigned long long seen = 0;
+		insideTask = true;
+
+		while(true) {
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [&] { return stopping or generation != seen; });
+				if(stopping)
+					return;
+				seen = generation;
+				active++;
+			}
+
+			runTasks();
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				active--;
+			}
+			finishedCondition.notify_all();
+		}
+	}
+
+	void ThreadPool::runTasks() {
+		unsigned int done = 0;
+		for(unsigned int i = next.fetch_add(1); i < taskCount; i = next.fetch_add(1)) {
+			try {
+				(*task)(i);
+			}
+			catch(...) {
+				std::lock_guard<std::mutex> lock(mutex);
+				if(not error)
+					error = std::current_exception();
+			}
+			done++;
+		}
+
+		if(done > 0) {
+			std::lock_guard<std::mutex> lock(mutex);
+			finished += done;
+		}
+	}
+
+	void ThreadPool::parallelFor(unsigned int count, const std::function<void(unsigned int)> &f) {
+		//  Laços pequenos, sem threads auxiliares ou aninhados são executados aqui mesmo.
+		if(count <= 1 or workers.empty() or insideTask) {
+			for(unsigned int i = 0; i < count; i++)
+				f(i);
+			return;
+		}
+
+		std::lock_guard<std::mutex> submit(submitMutex);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			task = &f;
+			taskCount = count;
+			finished = 0;
+			error = nullptr;
+			next.store(0);
+			generation++;
+		}
+		wake.notify_all();
+
+		insideTask = true;
+		runTasks();
+		insideTask = false;
+
+		//  Espera o fim das tarefas e a saída de todas as threads de runTasks, para que o
+		//próximo laço possa reescrever o estado com segurança.
+		std::exception_ptr e;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			finishedCondition.wait(lock, [&] { return finished == taskCount and active == 0; });
+			task = nullptr;
+			taskCount = 0;
+			e = error;
+		}
+		if(e)
+			std::rethrow_exception(e);
+	}
+
+	static std::unique_ptr<ThreadPool> globalPool;
+	static std::mutex globalMutex;
+	static unsigned int configuredThreads = 0;
+
+	static unsigned int defaultThreadCount() {
+		const unsigned int n = std::thread::hardware_concurrency();
+		return (n == 0) ? 1 : n;
+	}
+
+	ThreadPool &getThreadPool() {
+		std::lock_guard<std::mutex> lock(globalMutex);
+		if(not globalPool)
+			globalPool.reset(new ThreadPool(configuredThreads == 0 ? defaultThreadCount() : configuredThreads));
+		return *globalPool;
+	}
+
+	void setThreadCount(unsigned int n) {
+		std::lock_guard<std::mutex> lock(globalMutex);
+		configuredThreads = n;
+		globalPool.reset();
+	}
+
+	unsigned int getThreadCount() {
+		std::lock_guard<std::mutex> lock(globalMutex);
+		return configuredThreads == 0 ? defaultThreadCount() : configuredThreads;
+	}
+}
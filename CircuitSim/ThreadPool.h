@@ -0,0 +1,136 @@
+/********************************************************************************************
+ * @file ThreadPool.h
+ * @authors: Lucas Carvalho; Rafael Marasca Martins
+ * @date: 18 10 2026
+ * @brief Declaração da classe ThreadPool.
+ *
+ * Este arquivo contém a declaração do conjunto de threads usado pelos algoritmos paralelos
+ * do namespace NM e das funções que configuram o número de threads.
+ *
+ * O trabalho é sempre dividido em tarefas fixas, independentes do número de threads, de modo
+ * que os resultados numéricos não dependem de quantas threads executam as tarefas.
+ *
+ ********************************************************************************************/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NM {
+
+   /*************************************************************************
+    * Declaração da classe ThreadPool.
+    *
+    * Mantém threads dormindo até que um laço paralelo seja submetido. A
+    * thread que submete o laço também executa tarefas. Laços submetidos de
+    * dentro de uma tarefa são executados sequencialmente.
+    *************************************************************************/
+	class ThreadPool {
+	private:
+		std::vector<std::thread> workers; /**< Threads auxiliares (a thread que submete é a última).*/
+		std::mutex mutex; /**< Protege o estado do laço corrente.*/
+		std::mutex submitMutex; /**< Garante um único laço por vez.*/
+		std::condition_variable wake; /**< Acorda as threads auxiliares.*/
+		std::condition_variable finishedCondition; /**< Sinaliza o fim do laço.*/
+		const std::function<void(unsigned int)> *task; /**< Corpo do laço corrente.*/
+		unsigned int taskCount; /**< Número de tarefas do laço corrente.*/
+		std::atomic<unsigned int> next; /**< Próxima tarefa a ser executada.*/
+		unsigned int finished; /**< Tarefas concluídas.*/
+		unsigned int active; /**< Threads auxiliares executando tarefas.*/
+		unsigned long long generation; /**< Contador de laços submetidos.*/
+		std::exception_ptr error; /**< Primeira exceção lançada por uma tarefa.*/
+		bool stopping; /**< Indica que as threads devem terminar.*/
+
+	   /******************************************************************************************
+        * Laço das threads auxiliares.
+        *
+        * @return Void.
+        ******************************************************************************************/
+		void workerLoop();
+
+	   /******************************************************************************************
+        * Executa tarefas do laço corrente até que não reste nenhuma.
+        *
+        * @return Void.
+        ******************************************************************************************/
+		void runTasks();
+
+	public:
+	   /******************************************************************************************
+        * Construtor da classe ThreadPool.
+        *
+        * @param threads Número total de threads, incluindo a que submete os laços.
+        ******************************************************************************************/
+		explicit ThreadPool(unsigned int threads);
+
+	   /******************************************************************************************
+        * Desconstrutor da classe ThreadPool.
+        *
+        * Encerra e aguarda as threads auxiliares.
+        ******************************************************************************************/
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool &) = delete;
+		ThreadPool &operator=(const ThreadPool &) = delete;
+
+	   /******************************************************************************************
+        * Executa um laço paralelo.
+        *
+        * Chama f(i) para todo i em [0, count), distribuindo as tarefas entre as threads, e
+        * retorna quando todas terminarem. Uma exceção lançada por uma tarefa é relançada aqui.
+        *
+        * @param count Número de tarefas.
+        * @param f Corpo do laço.
+		*
+        * @return Void.
+        ******************************************************************************************/
+		void parallelFor(unsigned int count, const std::function<void(unsigned int)> &f);
+
+	   /******************************************************************************************
+        * Getter para o número de threads.
+        *
+        * @return Número total de threads, incluindo a que submete os laços.
+        ******************************************************************************************/
+		unsigned int getThreadCount() const;
+	};
+
+
+   /*************************************************************************
+    * Getter para o conjunto de threads global do namespace NM.
+    *
+    * Criado na primeira chamada com getThreadCount() threads.
+    *
+    * @return Conjunto de threads compartilhado.
+    *************************************************************************/
+	ThreadPool &getThreadPool();
+
+
+   /*************************************************************************
+    * Escolhe o número de threads dos algoritmos paralelos.
+    *
+    * Recria o conjunto global; não deve ser chamado enquanto um algoritmo
+    * paralelo estiver em execução.
+    *
+    * @param n Número de threads. Zero usa o número de núcleos da máquina.
+	*
+    * @return Void.
+    *************************************************************************/
+	void setThreadCount(unsigned int n);
+
+
+   /*************************************************************************
+    * Getter para o número de threads dos algoritmos paralelos.
+    *
+    * @return Número de threads configurado (por padrão, o número de núcleos).
+    *************************************************************************/
+	unsigned int getThreadCount();
+}
+
+#endif